@@ -0,0 +1,281 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Кольцевой буфер на RawMemory: очередь с двух концов и произвольным доступом по индексу.
+// PushBack/PushFront/PopBack/PopFront работают за O(1) (добавление - амортизированно),
+// в отличие от Vector::Erase(begin()), сдвигающего весь хвост.
+// Элементы занимают не больше двух непрерывных участков буфера: [head_, Capacity())
+// и [0, остаток). При росте они переносятся в начало нового буфера двумя перемещениями.
+template <typename T>
+class CircularVector {
+public:
+    CircularVector() = default;
+
+    explicit CircularVector(size_t size)
+        : data_(size)
+        , size_(size)  //
+    {
+        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    }
+
+    CircularVector(const CircularVector& other)
+        : data_(other.size_)
+        , size_(other.size_)  //
+    {
+        const auto [first, second] = other.Segments();
+        std::uninitialized_copy(first.begin(), first.end(), data_.GetAddress());
+        try {
+            std::uninitialized_copy(second.begin(), second.end(), data_ + first.size());
+        } catch (...) {
+            std::destroy_n(data_.GetAddress(), first.size());
+            throw;
+        }
+    }
+
+    CircularVector(CircularVector&& other) noexcept {
+        Swap(other);
+    }
+
+    CircularVector& operator=(const CircularVector& rhs) {
+        if (this != &rhs) {
+            CircularVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    CircularVector& operator=(CircularVector&& rhs) noexcept {
+        Swap(rhs);
+        return *this;
+    }
+
+    ~CircularVector() {
+        const auto [first, second] = Segments();
+        std::destroy(first.begin(), first.end());
+        std::destroy(second.begin(), second.end());
+    }
+
+    void Swap(CircularVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<CircularVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[PhysicalIndex(index)];
+    }
+
+    T& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const T& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    T& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const T& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        RawMemory<T> new_data(new_capacity);
+        RelocateTo(new_data, 0);
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PushFront(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == data_.Capacity()) {
+            GrowAndEmplace(size_, 0, std::forward<Args>(args)...);
+        } else {
+            std::construct_at(data_ + PhysicalIndex(size_), std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Back();
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        if (size_ == data_.Capacity()) {
+            GrowAndEmplace(0, 1, std::forward<Args>(args)...);
+        } else {
+            const size_t new_head = head_ == 0 ? data_.Capacity() - 1 : head_ - 1;
+            std::construct_at(data_ + new_head, std::forward<Args>(args)...);
+            head_ = new_head;
+        }
+        ++size_;
+        return Front();
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&Back());
+        --size_;
+    }
+
+    void PopFront() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&Front());
+        head_ = PhysicalIndex(1);
+        --size_;
+    }
+
+    // Делает элементы непрерывными и возвращает их. Если элементы уже непрерывны,
+    // ничего не делает; если в буфере хватает свободного места (а перемещение T не бросает
+    // исключений), переставляет их на месте; иначе переносит в новый буфер той же ёмкости.
+    // Ссылки и индексы в физическом буфере после вызова недействительны
+    std::span<T> Linearize() {
+        if (head_ + size_ <= data_.Capacity()) {
+            return {data_ + head_, size_};
+        }
+        if constexpr (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+            if (LinearizeInPlace()) {
+                return {data_ + head_, size_};
+            }
+        }
+        RawMemory<T> new_data(data_.Capacity());
+        RelocateTo(new_data, 0);
+        data_.Swap(new_data);
+        head_ = 0;
+        return {data_.GetAddress(), size_};
+    }
+
+private:
+    static constexpr bool RELOCATE_BY_MOVE = std::is_nothrow_move_constructible_v<T>
+                                             || !std::is_copy_constructible_v<T>;
+
+    size_t PhysicalIndex(size_t index) const noexcept {
+        const size_t position = head_ + index;
+        return position < data_.Capacity() ? position : position - data_.Capacity();
+    }
+
+    // Участки буфера, занятые элементами, в логическом порядке
+    std::pair<std::span<T>, std::span<T>> Segments() noexcept {
+        const size_t first_size = std::min(size_, data_.Capacity() - head_);
+        return {{data_ + head_, first_size}, {data_.GetAddress(), size_ - first_size}};
+    }
+
+    std::pair<std::span<const T>, std::span<const T>> Segments() const noexcept {
+        const auto [first, second] = const_cast<CircularVector&>(*this).Segments();
+        return {first, second};
+    }
+
+    static void Relocate(std::span<T> from, T* to) {
+        if constexpr (RELOCATE_BY_MOVE) {
+            std::uninitialized_move(from.begin(), from.end(), to);
+        } else {
+            std::uninitialized_copy(from.begin(), from.end(), to);
+        }
+    }
+
+    // Переносит элементы в new_data начиная с позиции offset двумя перемещениями
+    // и уничтожает их в старом буфере. При исключении текущий буфер не меняется
+    void RelocateTo(RawMemory<T>& new_data, size_t offset) {
+        const auto [first, second] = Segments();
+        Relocate(first, new_data + offset);
+        try {
+            Relocate(second, new_data + offset + first.size());
+        } catch (...) {
+            std::destroy_n(new_data + offset, first.size());
+            throw;
+        }
+        std::destroy(first.begin(), first.end());
+        std::destroy(second.begin(), second.end());
+    }
+
+    // Создаёт новый элемент в буфере удвоенной ёмкости до переноса старых элементов,
+    // чтобы аргументы могли ссылаться на элементы самого вектора.
+    // position - индекс нового элемента, offset - индекс, с которого размещаются старые
+    template <typename... Args>
+    void GrowAndEmplace(size_t position, size_t offset, Args&&... args) {
+        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+        std::construct_at(new_data + position, std::forward<Args>(args)...);
+        try {
+            RelocateTo(new_data, offset);
+        } catch (...) {
+            std::destroy_at(new_data + position);
+            throw;
+        }
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    // Перестановка на месте, когда один из двух участков помещается в свободное место:
+    // он перемещается в свободные ячейки, после чего оба участка стоят рядом,
+    // но в обратном порядке, и std::rotate меняет их местами
+    bool LinearizeInPlace() noexcept {
+        T* buffer = data_.GetAddress();
+        const auto [first, second] = Segments();
+        const size_t gap = data_.Capacity() - size_;
+        if (gap == 0) {
+            std::rotate(buffer, buffer + head_, buffer + data_.Capacity());
+            head_ = 0;
+            return true;
+        }
+        if (first.size() <= gap) {
+            // [second][first][свободно] -> rotate -> [first][second]
+            std::uninitialized_move(first.begin(), first.end(), buffer + second.size());
+            std::destroy(first.begin(), first.end());
+            std::rotate(buffer, buffer + second.size(), buffer + size_);
+            head_ = 0;
+            return true;
+        }
+        if (second.size() <= gap) {
+            // [свободно][second][first] -> rotate -> [first][second]
+            T* new_second = buffer + head_ - second.size();
+            std::uninitialized_move(second.begin(), second.end(), new_second);
+            std::destroy(second.begin(), second.end());
+            std::rotate(new_second, buffer + head_, buffer + data_.Capacity());
+            head_ -= second.size();
+            return true;
+        }
+        return false;
+    }
+
+    RawMemory<T> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
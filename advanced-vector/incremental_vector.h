@@ -0,0 +1,207 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <memory>
+#include <utility>
+
+// Вектор с постепенной реаллокацией.
+// Когда буфер заполнен, Vector переносит все элементы за один вызов EmplaceBack,
+// и время этого вызова растёт линейно с размером. IncrementalVector вместо этого
+// выделяет буфер вдвое большей ёмкости и держит оба буфера, пока идёт миграция:
+// каждый следующий EmplaceBack переносит не более MigrationStep старых элементов.
+// Ёмкость удваивается, поэтому миграция гарантированно заканчивается раньше,
+// чем заполнится новый буфер, и перенос элементов в одном EmplaceBack ограничен MigrationStep.
+// Худшее время всё же не постоянно: EmplaceBack, завершающий миграцию, освобождает старый буфер,
+// и для больших буферов (выделенных через mmap) это занимает время, пропорциональное числу
+// страниц. Кроме того, первые обращения к страницам нового буфера вызывают page faults.
+//
+// Если перемещение T может выбросить исключение, элементы переносятся копированием, как в Vector.
+// Исключение при переносе отменяет весь EmplaceBack: добавленный элемент удаляется,
+// а уже скопированные в этом вызове элементы остаются только в старом буфере.
+//
+// Во время миграции элементы лежат в двух буферах, поэтому вектор не предоставляет
+// непрерывных итераторов; доступ к элементам - по индексу.
+template <typename T, size_t MigrationStep = 8>
+class IncrementalVector {
+    static_assert(MigrationStep > 0, "Migration must make progress on every EmplaceBack");
+
+public:
+    IncrementalVector() = default;
+
+    IncrementalVector(const IncrementalVector& other) {
+        Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            EmplaceBack(other[i]);
+        }
+    }
+
+    IncrementalVector(IncrementalVector&& other) noexcept {
+        Swap(other);
+    }
+
+    IncrementalVector& operator=(const IncrementalVector& rhs) {
+        if (this != &rhs) {
+            IncrementalVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept {
+        Swap(rhs);
+        return *this;
+    }
+
+    ~IncrementalVector() {
+        std::destroy_n(data_.GetAddress(), migrated_);
+        std::destroy_n(data_ + old_size_, size_ - old_size_);
+        std::destroy_n(old_data_ + migrated_, old_size_ - migrated_);
+    }
+
+    void Swap(IncrementalVector& other) noexcept {
+        data_.Swap(other.data_);
+        old_data_.Swap(other.old_data_);
+        std::swap(size_, other.size_);
+        std::swap(old_size_, other.old_size_);
+        std::swap(migrated_, other.migrated_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Идёт ли перенос элементов из старого буфера
+    bool IsMigrating() const noexcept {
+        return migrated_ < old_size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<IncrementalVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        // Элементы [migrated_, old_size_) ещё не перенесены и лежат в старом буфере
+        if (index < migrated_ || index >= old_size_) {
+            return data_[index];
+        }
+        return old_data_[index];
+    }
+
+    // Заранее выделяет память. В отличие от EmplaceBack переносит все элементы сразу
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        FinishMigration();
+        RawMemory<T> new_data(new_capacity);
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        } else {
+            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+        }
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    }
+
+    // Завершает текущую миграцию целиком
+    void FinishMigration() {
+        MigrateBatch(old_size_ - migrated_);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == data_.Capacity()) {
+            StartMigration(std::forward<Args>(args)...);
+        } else {
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
+            ++size_;
+        }
+        // Новый элемент создан до переноса, поэтому аргументы, ссылающиеся
+        // на ещё не перенесённые элементы, остаются действительными.
+        // Если перенос выбросит исключение, элемент удаляется: иначе вектор рос бы без продвижения
+        // миграции и мог бы заполнить новый буфер раньше, чем она закончится
+        try {
+            MigrateBatch(MigrationStep);
+        } catch (...) {
+            --size_;
+            std::destroy_at(data_ + size_);
+            throw;
+        }
+        return data_[size_ - 1];
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        const size_t index = size_ - 1;
+        std::destroy_at(&(*this)[index]);
+        --size_;
+        if (index < old_size_) {
+            // Удалён последний ещё не перенесённый элемент: старая область укоротилась
+            old_size_ = index;
+            if (!IsMigrating()) {
+                ReleaseOldData();
+            }
+        }
+    }
+
+private:
+    template <typename... Args>
+    void StartMigration(Args&&... args) {
+        // Предыдущая миграция к этому моменту уже закончена благодаря удвоению ёмкости
+        assert(!IsMigrating());
+        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+        std::construct_at(new_data + size_, std::forward<Args>(args)...);
+        old_data_.Swap(data_);
+        data_.Swap(new_data);
+        old_size_ = size_;
+        migrated_ = 0;
+        ++size_;
+    }
+
+    // Переносит до count ещё не перенесённых элементов. Старые элементы уничтожаются только
+    // после переноса всей порции, поэтому при исключении во время копирования
+    // миграция остаётся в прежнем состоянии
+    void MigrateBatch(size_t count) {
+        const size_t number = std::min(old_size_, migrated_ + count) - migrated_;
+        T* from = old_data_ + migrated_;
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, number, data_ + migrated_);
+        } else {
+            std::uninitialized_copy_n(from, number, data_ + migrated_);
+        }
+        std::destroy_n(from, number);
+        migrated_ += number;
+        if (old_size_ != 0 && !IsMigrating()) {
+            ReleaseOldData();
+        }
+    }
+
+    void ReleaseOldData() noexcept {
+        RawMemory<T>().Swap(old_data_);
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+
+    RawMemory<T> data_;
+    // Буфер, из которого идёт миграция; пуст, если миграции нет
+    RawMemory<T> old_data_;
+    size_t size_ = 0;
+    // Размер вектора в момент начала миграции: элементы [0, old_size_) переносятся из old_data_
+    size_t old_size_ = 0;
+    // Элементы [0, migrated_) уже перенесены в data_
+    size_t migrated_ = 0;
+};
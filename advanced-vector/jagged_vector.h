@@ -0,0 +1,252 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор строк разной длины в формате CSR: элементы всех строк лежат подряд в одном Vector<T>,
+// а в offsets_ хранятся концы строк. В отличие от Vector<Vector<T>>,
+// строка не требует отдельного выделения памяти и заголовка, а обход всех элементов -
+// последовательное чтение одного буфера.
+//
+// Строки можно только добавлять в конец. EraseRow помечает строку удалённой, не сдвигая
+// данные, поэтому номера строк не меняются; Compact убирает удалённые строки и их элементы
+// и перенумеровывает оставшиеся. Добавление может перенести буфер элементов, поэтому
+// спаны строк действительны до следующего изменения.
+template <typename T>
+class JaggedVector {
+public:
+    // Число строк, включая удалённые, но ещё не убранные Compact
+    size_t RowCount() const noexcept {
+        return offsets_.Size();
+    }
+
+    // Число элементов во всех строках, включая удалённые
+    size_t ValueCount() const noexcept {
+        return values_.Size();
+    }
+
+    size_t ErasedRowCount() const noexcept {
+        return erased_count_;
+    }
+
+    bool IsErased(size_t row) const noexcept {
+        assert(row < RowCount());
+        return row < erased_.Size() && erased_[row];
+    }
+
+    size_t RowSize(size_t row) const noexcept {
+        assert(row < RowCount());
+        return offsets_[row] - RowBegin(row);
+    }
+
+    std::span<T> operator[](size_t row) noexcept {
+        assert(!IsErased(row));
+        return {values_.begin() + RowBegin(row), RowSize(row)};
+    }
+
+    std::span<const T> operator[](size_t row) const noexcept {
+        return const_cast<JaggedVector&>(*this)[row];
+    }
+
+    // Элементы всех строк подряд, включая удалённые
+    std::span<const T> Values() const noexcept {
+        return {values_.begin(), values_.Size()};
+    }
+
+    size_t RowCapacity() const noexcept {
+        return offsets_.Capacity();
+    }
+
+    size_t ValueCapacity() const noexcept {
+        return values_.Capacity();
+    }
+
+    void Reserve(size_t rows, size_t values) {
+        offsets_.Reserve(rows);
+        values_.Reserve(values);
+    }
+
+    void Clear() noexcept {
+        values_.Clear();
+        offsets_.Clear();
+        erased_.Clear();
+        erased_count_ = 0;
+    }
+
+    // Добавляет строку из элементов range и возвращает её номер.
+    // При исключении JaggedVector не меняется (кроме ёмкости)
+    template <std::ranges::forward_range Range>
+    size_t AppendRow(const Range& row) {
+        const size_t old_values = values_.Size();
+        AppendValues(row);
+        try {
+            offsets_.PushBack(values_.Size());
+        } catch (...) {
+            Truncate(RowCount(), old_values);
+            throw;
+        }
+        return RowCount() - 1;
+    }
+
+    size_t AppendRow(std::initializer_list<T> row) {
+        return AppendRow(std::span<const T>(row.begin(), row.size()));
+    }
+
+    // Добавляет строки из плоского представления: row_sizes[i] - длина i-й строки,
+    // values - элементы всех строк подряд. Память выделяется не больше одного раза на буфер
+    // и растёт не меньше чем вдвое, как у AppendRow, поэтому серия вызовов амортизированно линейна.
+    // Если сумма длин не равна числу элементов, выбрасывает std::invalid_argument.
+    // При исключении JaggedVector не меняется (кроме ёмкости)
+    template <std::ranges::forward_range SizesRange, std::ranges::forward_range ValuesRange>
+    void AppendRows(const SizesRange& row_sizes, const ValuesRange& values) {
+        size_t total = 0;
+        for (const size_t size : row_sizes) {
+            total += size;
+        }
+        if (total != static_cast<size_t>(std::ranges::distance(values))) {
+            throw std::invalid_argument("JaggedVector::AppendRows: row sizes do not match the number of values");
+        }
+        GrowFor(offsets_, static_cast<size_t>(std::ranges::distance(row_sizes)));
+        AppendValues(values);
+        // Память под смещения уже выделена, PushBack не выбросит исключений
+        size_t offset = values_.Size() - total;
+        for (const size_t size : row_sizes) {
+            offset += size;
+            offsets_.PushBack(offset);
+        }
+    }
+
+    // Добавляет копии неудалённых строк other (other не может быть этим же вектором)
+    void AppendRows(const JaggedVector& other) {
+        assert(&other != this);
+        const size_t old_rows = RowCount();
+        const size_t old_values = values_.Size();
+        const size_t live_rows = other.RowCount() - other.erased_count_;
+        size_t live_values = other.values_.Size();
+        for (size_t row = 0; row < other.erased_.Size(); ++row) {
+            if (other.erased_[row]) {
+                live_values -= other.RowSize(row);
+            }
+        }
+        GrowFor(offsets_, live_rows);
+        GrowFor(values_, live_values);
+        try {
+            for (size_t row = 0; row < other.RowCount(); ++row) {
+                if (!other.IsErased(row)) {
+                    AppendValues(other[row]);
+                    offsets_.PushBack(values_.Size());
+                }
+            }
+        } catch (...) {
+            Truncate(old_rows, old_values);
+            throw;
+        }
+    }
+
+    // Помечает строку удалённой. Её элементы остаются в буфере до Compact
+    void EraseRow(size_t row) {
+        assert(row < RowCount());
+        if (IsErased(row)) {
+            return;
+        }
+        if (erased_.Size() < RowCount()) {
+            erased_.Resize(RowCount());
+        }
+        erased_[row] = true;
+        ++erased_count_;
+    }
+
+    // Убирает удалённые строки, сдвигая элементы оставшихся к началу буфера.
+    // Ёмкость буферов сохраняется. Номера строк после вызова меняются
+    void Compact() {
+        if (erased_count_ == 0) {
+            return;
+        }
+        size_t write_row = 0;
+        size_t write_value = 0;
+        size_t first = 0;
+        for (size_t row = 0; row < RowCount(); ++row) {
+            const size_t last = offsets_[row];
+            if (!IsErased(row)) {
+                if (write_value != first) {
+                    std::move(values_.begin() + first, values_.begin() + last, values_.begin() + write_value);
+                }
+                write_value += last - first;
+                // write_row <= row, и смещения до row включительно уже прочитаны
+                offsets_[write_row++] = write_value;
+            }
+            first = last;
+        }
+        Truncate(write_row, write_value);
+        erased_.Clear();
+        erased_count_ = 0;
+    }
+
+private:
+    size_t RowBegin(size_t row) const noexcept {
+        return row == 0 ? 0 : offsets_[row - 1];
+    }
+
+    // Готовит место под count новых элементов, увеличивая ёмкость не меньше чем вдвое
+    // (как Vector::AppendN), чтобы серия небольших добавлений не копировала буфер каждый раз
+    template <typename U>
+    static void GrowFor(Vector<U>& v, size_t count) {
+        const size_t required = v.Size() + count;
+        if (required > v.Capacity()) {
+            v.Reserve(std::max(required, v.Capacity() * 2));
+        }
+    }
+
+    // Непрерывный диапазон может лежать в самом values_ (например, j.AppendRow(j[0])),
+    // а добавление переносит буфер. Такой диапазон копируется по индексам уже после
+    // выделения памяти, как Vector::EmplaceBack создаёт элемент до переноса старых.
+    // Прочие диапазоны не должны ссылаться на элементы этого JaggedVector
+    template <typename Range>
+    void AppendValues(const Range& range) {
+        const size_t count = static_cast<size_t>(std::ranges::distance(range));
+        if constexpr (std::ranges::contiguous_range<Range>
+                      && std::is_same_v<std::ranges::range_value_t<Range>, T>) {
+            const T* first = std::ranges::data(range);
+            const std::less<const T*> less;
+            if (count != 0 && !less(first, values_.begin()) && less(first, values_.end())) {
+                const size_t offset = first - values_.begin();
+                GrowFor(values_, count);
+                values_.AppendN(count, [this, offset](size_t i) {
+                    return values_[offset + i];
+                });
+                return;
+            }
+        }
+        auto it = std::ranges::begin(range);
+        values_.AppendN(count, [&it] {
+            return static_cast<T>(*it++);
+        });
+    }
+
+    // Оставляет первые rows строк и values элементов
+    void Truncate(size_t rows, size_t values) noexcept {
+        while (values_.Size() > values) {
+            values_.PopBack();
+        }
+        while (offsets_.Size() > rows) {
+            offsets_.PopBack();
+        }
+    }
+
+    Vector<T> values_;
+    // Концы строк: строка i - [offsets_[i - 1], offsets_[i]), первая начинается с нуля.
+    // Без ведущего нуля пустой JaggedVector не выделяет памяти и остаётся пустым после перемещения
+    Vector<size_t> offsets_;
+    // Пометки удалённых строк; пуст, пока ни одна строка не удалена
+    Vector<bool> erased_;
+    size_t erased_count_ = 0;
+};
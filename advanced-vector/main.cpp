@@ -1,8 +1,26 @@
 #include "vector.h"
+#include "circular_vector.h"
+#include "incremental_vector.h"
+#include "jagged_vector.h"
+#include "shared_vector.h"
+#include "trim_registry.h"
+#include "vector_parallel.h"
+#include "vector_profiler.h"
+#include "vector_simd.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -11,15 +29,15 @@ namespace {
 inline const uint32_t DEFAULT_COOKIE = 0xdeadbeef;
 
 struct TestObj {
-    TestObj() = default;
-    TestObj(const TestObj& other) = default;
-    TestObj& operator=(const TestObj& other) = default;
-    TestObj(TestObj&& other) = default;
-    TestObj& operator=(TestObj&& other) = default;
-    ~TestObj() {
+    constexpr TestObj() = default;
+    constexpr TestObj(const TestObj& other) = default;
+    constexpr TestObj& operator=(const TestObj& other) = default;
+    constexpr TestObj(TestObj&& other) = default;
+    constexpr TestObj& operator=(TestObj&& other) = default;
+    constexpr ~TestObj() {
         cookie = 0;
     }
-    [[nodiscard]] bool IsAlive() const noexcept {
+    [[nodiscard]] constexpr bool IsAlive() const noexcept {
         return cookie == DEFAULT_COOKIE;
     }
     uint32_t cookie = DEFAULT_COOKIE;
@@ -287,8 +305,9 @@ void Test3() {
         v_small = v;
         assert(v_small.Size() == v.Size());
         assert(v_small.Capacity() == MEDIUM_SIZE + 1);
-        v_small[MEDIUM_SIZE - 1].id = ID;
+        assert(v_small[MEDIUM_SIZE - 1].id == ID);
         assert(Obj::num_copied - num_copies == MEDIUM_SIZE - (MEDIUM_SIZE / 2));
+        assert(Obj::num_assigned == MEDIUM_SIZE / 2);
     }
 }
 
@@ -558,6 +577,1455 @@ void Test6() {
     }
 }
 
+template <typename T>
+void TestSimdOpsForType() {
+    using namespace simd_detail;
+    const size_t SIZE = 1000;
+    // Смещения начала заставляют ядра обрабатывать невыровненную "голову",
+    // разные длины - неполный "хвост"
+    for (size_t offset = 0; offset < 9; ++offset) {
+        for (size_t n : {size_t{0}, size_t{1}, size_t{7}, size_t{64}, size_t{129}, SIZE - 1 - offset}) {
+            Vector<T> v(SIZE);
+            Vector<T> expected(SIZE);
+            T* data = v.begin() + offset;
+            T* ref = expected.begin() + offset;
+
+            Dispatch<IotaOp>(data, n, T(-100));
+            IotaOp::RunScalar(ref, n, T(-100));
+            assert(std::equal(data, data + n, ref));
+
+            assert(Dispatch<SumOp>(static_cast<const T*>(data), n) == SumOp::RunScalar(ref, n));
+            if (n != 0) {
+                const auto expected_min_max = std::pair<T, T>{*std::min_element(ref, ref + n),
+                                                              *std::max_element(ref, ref + n)};
+                assert(Dispatch<MinMaxOp>(static_cast<const T*>(data), n, std::pair<T, T>{data[0], data[0]})
+                       == expected_min_max);
+            }
+            for (T needle : {T(-100), T(-50), T(-100 + static_cast<T>(n) - 1), T(100500)}) {
+                assert(Dispatch<FindOp>(static_cast<const T*>(data), n, needle)
+                       == static_cast<size_t>(std::find(ref, ref + n, needle) - ref));
+            }
+
+            Dispatch<TransformOp>(data, n, T(3), T(-2));
+            TransformOp::RunScalar(ref, n, T(3), T(-2));
+            assert(std::equal(data, data + n, ref));
+
+            const Vector<T> x(v);
+            Dispatch<AxpyOp>(data, x.begin() + 1, n, T(2));
+            AxpyOp::RunScalar(ref, x.begin() + 1, n, T(2));
+            assert(std::equal(data, data + n, ref));
+
+            Dispatch<FillOp>(data, n, T(7));
+            data[n / 2] = T(8);
+            assert(Dispatch<CountOp>(static_cast<const T*>(data), n, T(7)) == (n == 0 ? 0 : n - 1));
+            assert(std::count(data, data + n, T(7)) == static_cast<std::ptrdiff_t>(n == 0 ? 0 : n - 1));
+        }
+    }
+    {
+        Vector<T> v(SIZE);
+        Iota(v, T(1));
+        assert(Sum(v) == T(SIZE * (SIZE + 1) / 2));
+        assert(MinMax(v) == (std::pair<T, T>{T(1), T(SIZE)}));
+        assert(Find(v, T(10)) == v.begin() + 9);
+        assert(Find(v, T(0)) == v.end());
+        Transform(v, T(0), T(5));
+        assert(Count(v, T(5)) == SIZE);
+        Vector<T> x(SIZE);
+        Fill(x, T(2));
+        Axpy(v, T(3), x);
+        assert(Count(v, T(11)) == SIZE);
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        // На дробных значениях SIMD-ветка должна совпадать со скалярной побитово,
+        // то есть не объединять умножение и сложение в FMA
+        Vector<T> v(SIZE);
+        Vector<T> x(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = T(1) / T(i + 3) - T(0.3);
+            x[i] = T(i) * T(0.37) + T(1) / T(i + 7);
+        }
+        Vector<T> expected(v);
+        Transform(v, T(1.1), T(-0.7));
+        TransformOp::RunScalar(expected.begin(), SIZE, T(1.1), T(-0.7));
+        assert(std::equal(v.begin(), v.end(), expected.begin()));
+        Axpy(v, T(0.3), x);
+        AxpyOp::RunScalar(expected.begin(), x.begin(), SIZE, T(0.3));
+        assert(std::equal(v.begin(), v.end(), expected.begin()));
+    }
+}
+
+void Test7() {
+    const SimdLevel detected = DetectedSimdLevel();
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE4_2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (detected < level) {
+            break;
+        }
+        ForceSimdLevel(level);
+        assert(ActiveSimdLevel() == level);
+        TestSimdOpsForType<float>();
+        TestSimdOpsForType<double>();
+        TestSimdOpsForType<int32_t>();
+        TestSimdOpsForType<int64_t>();
+    }
+    ForceSimdLevel(detected);
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        SharedVector<Obj> v(SIZE);
+        SharedVector<Obj> snapshot(v);
+        assert(v.UseCount() == 2);
+        assert(std::as_const(snapshot).begin() == std::as_const(v).begin());
+        assert(Obj::num_copied == 0);
+
+        // Первая запись отделяет буфер, снимок остаётся прежним
+        v[0].id = ID;
+        assert(!v.IsShared() && !snapshot.IsShared());
+        assert(v[0].id == ID);
+        assert(snapshot[0].id == 0);
+        assert(Obj::num_copied == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE * 2);
+
+        // Повторная запись в единоличный буфер ничего не копирует
+        v.EmplaceBack(ID);
+        v.Erase(v.cbegin());
+        assert(Obj::num_copied == SIZE);
+        assert(v.Size() == SIZE);
+        assert(snapshot.Size() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SharedVector<Obj> v;
+        v.EmplaceBack(ID);
+        SharedVector<Obj> snapshot = v;
+        // Аргумент ссылается на разделяемый буфер, который отделяется при вставке
+        const Obj& shared_first = std::as_const(snapshot)[0];
+        assert(v.UseCount() == 2 && &shared_first == &std::as_const(v)[0]);
+        v.PushBack(shared_first);
+        assert(snapshot.UseCount() == 1 && &std::as_const(snapshot)[0] == &shared_first);
+        // Одна копия при отделении и одна - новый элемент
+        assert(Obj::num_copied == 2);
+        assert(v.Size() == 2 && snapshot.Size() == 1);
+        assert(v.Capacity() >= 2);
+        assert(std::as_const(v)[1].id == ID);
+        snapshot = v;
+        assert(v.UseCount() == 2);
+        snapshot.Insert(snapshot.cbegin(), Obj{ID + 1});
+        assert(snapshot[0].id == ID + 1);
+        assert(v.Size() == 2 && v[0].id == ID);
+        {
+            SharedVector<Obj> empty;
+            assert(empty.Size() == 0 && empty.UseCount() == 0);
+            empty = std::move(snapshot);
+            assert(empty.Size() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> data(SIZE);
+        data[SIZE / 2].throw_on_copy = true;
+        SharedVector<Obj> v(std::move(data));
+        SharedVector<Obj> snapshot(v);
+        try {
+            v.PopBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.UseCount() == 2);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+    {
+        // Ссылка для записи, выданная до снимка, не меняет снимок
+        SharedVector<int> v(3);
+        int& first = v[0];
+        SharedVector<int> snapshot = v;
+        assert(!v.IsShared() && !snapshot.IsShared());
+        first = ID;
+        assert(std::as_const(snapshot)[0] == 0 && std::as_const(v)[0] == ID);
+        // Константный доступ буфер не закрывает
+        SharedVector<int> reader = snapshot;
+        assert(std::as_const(reader)[0] == 0 && snapshot.UseCount() == 2);
+        // Модифицирующая операция снова разрешает разделение
+        v.PushBack(1);
+        SharedVector<int> shared = v;
+        assert(v.UseCount() == 2 && std::as_const(shared)[0] == ID);
+    }
+    {
+        // Reserve и Resize разделяемого буфера выделяют ровно запрошенную ёмкость, как Vector,
+        // а добавление элемента увеличивает её вдвое
+        SharedVector<int> v(SIZE);
+        SharedVector<int> snapshot = v;
+        v.Reserve(SIZE + 1);
+        assert(v.Capacity() == SIZE + 1 && snapshot.Capacity() == SIZE);
+        snapshot = v;
+        v.Resize(SIZE + 3);
+        assert(v.Capacity() == SIZE + 3 && v.Size() == SIZE + 3);
+        snapshot = v;
+        v.Reserve(SIZE);
+        assert(v.Capacity() == SIZE + 3 && !v.IsShared());
+        snapshot = v;
+        v.PushBack(1);
+        assert(v.Capacity() == (SIZE + 3) * 2 && snapshot.Size() == SIZE + 3);
+    }
+    {
+        // Снимки можно передавать в другие потоки, пока писатель продолжает добавлять элементы
+        SharedVector<int> v;
+        std::vector<std::thread> readers;
+        std::atomic<size_t> checked = 0;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+            if (i % 100 == 99) {
+                readers.emplace_back([snapshot = v, &checked] {
+                    for (size_t j = 0; j < snapshot.Size(); ++j) {
+                        assert(snapshot[j] == static_cast<int>(j));
+                    }
+                    checked += snapshot.Size();
+                });
+            }
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(checked == 100 * (1 + 10) * 10 / 2);
+    }
+}
+
+// Test1-Test6 в виде, допускающем вычисление на этапе компиляции.
+// Obj ведёт статические счётчики и не является литеральным типом, поэтому здесь
+// используются int и TestObj; утечки и обращения к неживым объектам диагностирует компилятор.
+// Аналога Test2 нет: выбросить исключение на этапе компиляции нельзя
+constexpr bool ConstexprTest1() {
+    const size_t SIZE = 100;
+    const size_t INDEX = 10;
+    const int MAGIC = 42;
+    {
+        Vector<int> v;
+        assert(v.Capacity() == 0 && v.Size() == 0);
+        v.Reserve(SIZE);
+        assert(v.Capacity() == SIZE && v.Size() == 0);
+    }
+    {
+        Vector<int> v(SIZE);
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+        assert(v[0] == 0);
+        v[INDEX] = MAGIC;
+        v.Reserve(SIZE * 2);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE * 2);
+        assert(v[INDEX] == MAGIC);
+        const auto v_copy(v);
+        assert(&v[INDEX] != &v_copy[INDEX]);
+        assert(v[INDEX] == v_copy[INDEX]);
+    }
+    return true;
+}
+
+constexpr bool ConstexprTest3() {
+    const size_t MEDIUM_SIZE = 10;
+    const size_t LARGE_SIZE = 25;
+    const int ID = 42;
+    {
+        Vector<int> v(MEDIUM_SIZE);
+        v[MEDIUM_SIZE / 2] = ID;
+        Vector<int> moved_from_v(std::move(v));
+        assert(moved_from_v.Size() == MEDIUM_SIZE && moved_from_v[MEDIUM_SIZE / 2] == ID);
+        assert(v.Size() == 0);
+    }
+    {
+        Vector<int> v_medium(MEDIUM_SIZE);
+        v_medium[MEDIUM_SIZE / 2] = ID;
+        Vector<int> v_large(LARGE_SIZE);
+        v_large = v_medium;
+        assert(v_large.Size() == MEDIUM_SIZE && v_large.Capacity() == LARGE_SIZE);
+        assert(v_large[MEDIUM_SIZE / 2] == ID);
+        v_medium = v_large;
+        v_large = Vector<int>(LARGE_SIZE);
+        v_medium = v_large;
+        assert(v_medium.Size() == LARGE_SIZE);
+    }
+    return true;
+}
+
+constexpr bool ConstexprTest4() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Vector<TestObj> v;
+        v.Resize(SIZE);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        v.Resize(SIZE / 2);
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE);
+    }
+    {
+        Vector<int> v(SIZE);
+        v.PushBack(ID);
+        assert(v.Size() == SIZE + 1 && v.Capacity() == SIZE * 2);
+        assert(v[SIZE] == ID);
+        v.PopBack();
+        assert(v.Size() == SIZE);
+    }
+    {
+        Vector<TestObj> v(1);
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive() && v[1].IsAlive());
+        v.PushBack(std::move(v[0]));
+        assert(v[0].IsAlive() && v[2].IsAlive());
+    }
+    return true;
+}
+
+constexpr bool ConstexprTest5() {
+    Vector<TestObj> v(1);
+    auto& elem = v.EmplaceBack(v[0]);
+    assert(&elem == &v[1]);
+    assert(v[0].IsAlive() && v[1].IsAlive());
+    return true;
+}
+
+constexpr bool ConstexprTest6() {
+    const size_t SIZE = 10;
+    {
+        Vector<int> v(SIZE);
+        v.PushBack(1);
+        *v.begin() = 2;
+        assert(v[0] == 2);
+        assert(v.end() - v.begin() == static_cast<std::ptrdiff_t>(v.Size()));
+    }
+    {
+        Vector<int> v(SIZE);
+        auto pos = v.Insert(v.cbegin() + 1, 1);
+        assert(v.Size() == SIZE + 1 && v.Capacity() == SIZE * 2);
+        assert(pos == v.begin() + 1 && *pos == 1);
+        pos = v.Emplace(v.cbegin() + 3, 3);
+        assert(v.Size() == SIZE + 2 && *pos == 3);
+        pos = v.Erase(v.cbegin() + 1);
+        assert(pos == v.begin() + 1 && v[2] == 3 && v.Size() == SIZE + 1);
+    }
+    {
+        Vector<TestObj> v(SIZE);
+        v.Insert(v.cbegin() + 2, v[0]);
+        v.Emplace(v.cbegin() + 2, std::move(v[0]));
+        v.Erase(v.cbegin());
+        for (const TestObj& obj : v) {
+            assert(obj.IsAlive());
+        }
+    }
+    return true;
+}
+
+// Присваивание вектору с достаточной ёмкостью: хвост создаётся после уже присвоенных элементов
+constexpr bool ConstexprTest7() {
+    {
+        Vector<int> source(5);
+        for (size_t i = 0; i < source.Size(); ++i) {
+            source[i] = static_cast<int>(i) + 1;
+        }
+        Vector<int> v(2);
+        v.Reserve(8);
+        v = source;
+        assert(v.Size() == 5 && v.Capacity() == 8);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i) + 1);
+        }
+        Vector<int> shorter(1);
+        v = shorter;
+        assert(v.Size() == 1 && v.Capacity() == 8 && v[0] == 0);
+    }
+    {
+        Vector<TestObj> source(6);
+        Vector<TestObj> v(3);
+        v.Reserve(6);
+        v = source;
+        assert(v.Size() == 6);
+        for (const TestObj& obj : v) {
+            assert(obj.IsAlive());
+        }
+    }
+    return true;
+}
+
+// Таблица, построенная через EmplaceBack на этапе компиляции и скопированная в статический массив
+template <size_t N>
+constexpr std::array<uint32_t, N> MakeSquaresTable() {
+    Vector<uint32_t> squares;
+    for (uint32_t i = 0; i < N; ++i) {
+        squares.EmplaceBack(i * i);
+    }
+    std::array<uint32_t, N> table{};
+    std::copy(squares.begin(), squares.end(), table.begin());
+    return table;
+}
+
+static_assert(ConstexprTest1());
+static_assert(ConstexprTest3());
+static_assert(ConstexprTest4());
+static_assert(ConstexprTest5());
+static_assert(ConstexprTest6());
+static_assert(ConstexprTest7());
+
+void Test9() {
+    static constexpr auto SQUARES = MakeSquaresTable<256>();
+    static_assert(SQUARES[255] == 255 * 255);
+    for (uint32_t i = 0; i < SQUARES.size(); ++i) {
+        assert(SQUARES[i] == i * i);
+    }
+    // Те же функции работают и во время выполнения
+    assert(ConstexprTest1() && ConstexprTest3() && ConstexprTest4() && ConstexprTest5() && ConstexprTest6());
+}
+
+template <typename SizeType>
+void TestSizeTypeOperations() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    Obj::ResetCounters();
+    {
+        Vector<Obj, SizeType> v(SIZE);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        v.EmplaceBack(ID);
+        assert(v.Size() == SIZE + 1 && v.Capacity() == SIZE * 2);
+        assert(v[SIZE].id == ID);
+        v.Insert(v.cbegin(), Obj{ID + 1});
+        assert(v[0].id == ID + 1);
+        v.Erase(v.cbegin());
+        v.Resize(SIZE / 2);
+        const Vector<Obj, SizeType> v_copy(v);
+        assert(v_copy.Size() == SIZE / 2 && v_copy.Capacity() == SIZE / 2);
+        Vector<Obj, SizeType> v_moved(std::move(v));
+        assert(v_moved.Capacity() == SIZE * 2 && v.Capacity() == 0);
+        v = v_copy;
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2 * 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test10() {
+    static_assert(sizeof(Vector<int>) == 24);
+    static_assert(sizeof(Vector<int, uint32_t>) == 16);
+    static_assert(sizeof(Vector<int, HeapCapacity<>>) == 16);
+    static_assert(sizeof(Vector<int, HeapCapacity<uint32_t>>) == 16);
+
+    TestSizeTypeOperations<uint32_t>();
+    TestSizeTypeOperations<uint16_t>();
+    TestSizeTypeOperations<HeapCapacity<>>();
+    TestSizeTypeOperations<HeapCapacity<uint32_t>>();
+    {
+        // Рост упирается в наибольшую ёмкость SizeType, после чего вектор перестаёт расти
+        Vector<int, uint8_t> v;
+        for (int i = 0; i < 255; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 255 && v.Capacity() == 255);
+        try {
+            v.PushBack(255);
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 255 && v[254] == 254);
+        try {
+            v.Reserve(256);
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        try {
+            Vector<int, uint8_t> too_large(256);
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+    }
+    {
+        // Заголовок с ёмкостью не нарушает выравнивание элементов
+        struct alignas(64) Aligned {
+            int value = 0;
+        };
+        Vector<Aligned, HeapCapacity<>> v(3);
+        v.Reserve(10);
+        assert(v.Capacity() == 10);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+    }
+}
+
+// Как Obj, но конструктор перемещения не помечен noexcept и может выбросить исключение
+struct ThrowingMoveObj {
+    ThrowingMoveObj() {
+        ++num_constructed;
+    }
+
+    explicit ThrowingMoveObj(int id)
+        : id(id)
+        , payload(64, 'x')  //
+    {
+        ++num_constructed;
+    }
+
+    ThrowingMoveObj(const ThrowingMoveObj& other)
+        : id(other.id)
+        , payload(other.payload)  //
+    {
+        if (other.throw_on_copy) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_copied;
+    }
+
+    ThrowingMoveObj(ThrowingMoveObj&& other)
+        : id(other.id)
+        , payload(std::move(other.payload))  //
+    {
+        if (move_throw_countdown > 0 && --move_throw_countdown == 0) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_moved;
+    }
+
+    ThrowingMoveObj& operator=(const ThrowingMoveObj& other) = default;
+    ThrowingMoveObj& operator=(ThrowingMoveObj&& other) = default;
+
+    ~ThrowingMoveObj() {
+        ++num_destroyed;
+    }
+
+    static int GetAliveObjectCount() {
+        return num_constructed + num_copied + num_moved - num_destroyed;
+    }
+
+    static void ResetCounters() {
+        move_throw_countdown = 0;
+        num_constructed = 0;
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+    }
+
+    bool throw_on_copy = false;
+    int id = 0;
+    std::string payload;
+
+    // Счётчики атомарные: объекты создаются и уничтожаются и в параллельных операциях
+    static inline std::atomic<int> move_throw_countdown = 0;
+    static inline std::atomic<int> num_constructed = 0;
+    static inline std::atomic<int> num_copied = 0;
+    static inline std::atomic<int> num_moved = 0;
+    static inline std::atomic<int> num_destroyed = 0;
+};
+
+void Test11() {
+    const size_t SIZE = 100;
+    using FastVector = Vector<ThrowingMoveObj, size_t, FastRelocation>;
+    {
+        ThrowingMoveObj::ResetCounters();
+        CopyFallbackReport::Instance().Reset();
+        Vector<ThrowingMoveObj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        assert(ThrowingMoveObj::num_copied == SIZE);
+        assert(ThrowingMoveObj::num_moved == 0);
+#ifndef NDEBUG
+        const auto entry = CopyFallbackReport::Instance().Get(typeid(ThrowingMoveObj));
+        assert(entry.calls == 1 && entry.elements == SIZE);
+        assert(CopyFallbackReport::Instance().Get(typeid(Obj)).calls == 0);
+#endif
+    }
+    {
+        ThrowingMoveObj::ResetCounters();
+        CopyFallbackReport::Instance().Reset();
+        FastVector v(SIZE);
+        v.Reserve(SIZE * 2);
+        v.Resize(SIZE * 2);
+        v.EmplaceBack(1);
+        assert(ThrowingMoveObj::num_copied == 0);
+        assert(ThrowingMoveObj::num_moved == SIZE * 3);
+        assert(CopyFallbackReport::Instance().Get(typeid(ThrowingMoveObj)).calls == 0);
+    }
+    assert(ThrowingMoveObj::GetAliveObjectCount() == 0);
+    {
+        // Базовая гарантия: при исключении вектор остаётся корректным и ничего не утекает
+        ThrowingMoveObj::ResetCounters();
+        FastVector v(SIZE);
+        ThrowingMoveObj::move_throw_countdown = SIZE / 2;
+        try {
+            v.Reserve(SIZE * 2);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(ThrowingMoveObj::GetAliveObjectCount() == SIZE);
+
+        ThrowingMoveObj::move_throw_countdown = SIZE / 2;
+        try {
+            v.Insert(v.cbegin() + SIZE / 4, ThrowingMoveObj(1));
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(ThrowingMoveObj::GetAliveObjectCount() == SIZE);
+        v.EmplaceBack(2);
+        assert(v.Size() == SIZE + 1 && v[SIZE].id == 2);
+    }
+    assert(ThrowingMoveObj::GetAliveObjectCount() == 0);
+    {
+        // Строгая гарантия: исключение при копировании во время реаллокации не меняет вектор
+        ThrowingMoveObj::ResetCounters();
+        Vector<ThrowingMoveObj> v(SIZE);
+        v[SIZE / 2].throw_on_copy = true;
+        try {
+            v.EmplaceBack(1);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(v[SIZE / 2].throw_on_copy);
+        assert(ThrowingMoveObj::GetAliveObjectCount() == SIZE);
+    }
+    assert(ThrowingMoveObj::GetAliveObjectCount() == 0);
+}
+
+void Test12() {
+    const size_t SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        IncrementalVector<Obj, 4> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+            // За один EmplaceBack переносится не больше 4 элементов
+            assert(Obj::num_moved <= static_cast<int>(4 * (i + 1)));
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(i + 1));
+        }
+        assert(v.Size() == SIZE && v.Capacity() == 1024);
+        // 1000 = 512 + 488: миграция из буфера на 512 элементов уже завершена
+        assert(!v.IsMigrating());
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        assert(Obj::num_copied == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        IncrementalVector<Obj, 2> v;
+        for (int i = 0; i < 16; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Запускаем миграцию 16 элементов и добавляем элемент, ещё лежащий в старом буфере
+        v.PushBack(v[15]);
+        assert(v.IsMigrating() && v.Capacity() == 32);
+        assert(v[16].id == 15);
+        for (int i = 0; i < 17; ++i) {
+            assert(v[i].id == std::min(i, 15));
+        }
+        // Индексация охватывает оба буфера, в том числе запись
+        v[10].id = 100;
+        v.PushBack(Obj{17});
+        assert(v[10].id == 100);
+
+        // PopBack по всем областям: добавленные, не перенесённые и перенесённые элементы
+        while (v.Size() > 3) {
+            v.PopBack();
+        }
+        assert(!v.IsMigrating());
+        assert(v[0].id == 0 && v[2].id == 2);
+        assert(Obj::GetAliveObjectCount() == 3);
+
+        IncrementalVector<Obj, 2> v_copy(v);
+        v.Reserve(100);
+        assert(v.Capacity() == 100 && v.Size() == 3);
+        assert(v_copy.Size() == 3 && v_copy[1].id == 1);
+        IncrementalVector<Obj, 2> v_moved(std::move(v_copy));
+        assert(v_moved.Size() == 3 && v_copy.Size() == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        IncrementalVector<Obj, 1> v;
+        for (int i = 0; i < 64; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.EmplaceBack(64);
+        assert(v.IsMigrating());
+        v.FinishMigration();
+        assert(!v.IsMigrating());
+        assert(v[0].id == 0 && v[64].id == 64);
+        IncrementalVector<Obj, 1> other;
+        other.EmplaceBack(1);
+        other.EmplaceBack(2);
+        other = v;
+        assert(other.Size() == 65);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Бросающее перемещение: элементы переносятся копированием, и исключение
+        // при копировании отменяет EmplaceBack целиком
+        ThrowingMoveObj::ResetCounters();
+        IncrementalVector<ThrowingMoveObj, 2> v;
+        for (int i = 0; i < 8; ++i) {
+            v.EmplaceBack(i);
+        }
+        v[3].throw_on_copy = true;
+        // Начинает миграцию в буфер на 16 элементов и переносит элементы 0 и 1
+        v.EmplaceBack(8);
+        assert(v.IsMigrating() && v.Size() == 9);
+        for (int attempt = 0; attempt < 20; ++attempt) {
+            try {
+                v.EmplaceBack(100);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            // Вектор не растёт, пока миграция не может продвинуться
+            assert(v.Size() == 9 && v.Capacity() == 16 && v.IsMigrating());
+            assert(ThrowingMoveObj::GetAliveObjectCount() == 9);
+        }
+        v[3].throw_on_copy = false;
+        for (int i = 9; i < 40; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.Size() == 40 && ThrowingMoveObj::num_moved == 0);
+        for (int i = 0; i < 40; ++i) {
+            assert(v[i].id == i);
+        }
+    }
+    assert(ThrowingMoveObj::GetAliveObjectCount() == 0);
+}
+
+void Test13() {
+    // Профиль общий для процесса: при сборке с VECTOR_PROFILING в нём уже есть замеры других тестов
+    const auto before = VectorProfile::Instance().Get("Touch", typeid(int));
+    // 64 МиБ больше наибольшего порога mmap в glibc, поэтому память всегда свежая
+    const size_t SIZE = 1 << 24;
+    {
+        ScopedPerfCounter scope("Touch", typeid(int));
+        Vector<int> v(SIZE);
+        assert(v[SIZE - 1] == 0);
+    }
+    {
+        ScopedPerfCounter scope("Touch", typeid(int));
+    }
+    const auto stats = VectorProfile::Instance().Get("Touch", typeid(int));
+    assert(stats.calls == before.calls + 2);
+    // Без доступа к perf_event_open счётчики молча возвращают нули
+    if (PerfCounters::ThisThread().IsAvailable()) {
+        // Страницы свежей памяти отображаются при первом обращении
+        assert(stats.total.page_faults > before.total.page_faults);
+    }
+    if (PerfCounters::ThisThread().HasHardwareCounters()) {
+        assert(stats.total.instructions >= before.total.instructions + SIZE);
+    }
+    assert(VectorProfile::Instance().Get("Touch", typeid(double)).calls == 0);
+
+    std::ostringstream report;
+    VectorProfile::Instance().Print(report);
+    assert(report.str().find("Touch<int>: ") != std::string::npos);
+}
+
+void Test14() {
+    {
+        // Тысячи элементов на источник, чтобы перенос действительно шёл в нескольких потоках
+        const int NUM_PARTS = 5;
+        const int PART_SIZE = 10'000;
+        Vector<Vector<std::string>> parts(NUM_PARTS);
+        for (int part = 0; part < NUM_PARTS; ++part) {
+            // Источники разного размера, один из них пустой
+            for (int i = 0; i < PART_SIZE * part; ++i) {
+                parts[part].EmplaceBack(std::to_string(part * 1'000'000 + i));
+            }
+        }
+        Vector<std::string> v;
+        v.EmplaceBack("first");
+        v.ConcatFrom(parts, 4);
+        const size_t total = 1 + PART_SIZE * (0 + 1 + 2 + 3 + 4);
+        assert(v.Size() == total && v.Capacity() == total);
+        assert(v[0] == "first");
+        size_t index = 1;
+        for (int part = 0; part < NUM_PARTS; ++part) {
+            assert(parts[part].Size() == 0);
+            for (int i = 0; i < PART_SIZE * part; ++i) {
+                assert(v[index++] == std::to_string(part * 1'000'000 + i));
+            }
+        }
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Vector<Obj>> parts(3);
+        for (int i = 0; i < 3; ++i) {
+            parts[i].EmplaceBack(i);
+            parts[i].EmplaceBack(i);
+        }
+        Vector<Obj> v = ParallelCollect(std::span(parts.begin(), parts.end()), 1);
+        assert(v.Size() == 6 && v[0].id == 0 && v[5].id == 2);
+        assert(Obj::num_copied == 0);
+        assert(Obj::GetAliveObjectCount() == 6);
+    }
+    {
+        // Исключение при копировании в одном из потоков: вектор и источники не меняются
+        const int NUM_PARTS = 4;
+        const int PART_SIZE = 10'000;
+        ThrowingMoveObj::ResetCounters();
+        {
+            Vector<Vector<ThrowingMoveObj>> parts(NUM_PARTS);
+            for (auto& part : parts) {
+                part.Resize(PART_SIZE);
+            }
+            parts[2][PART_SIZE / 2].throw_on_copy = true;
+            Vector<ThrowingMoveObj> v(1);
+            try {
+                v.ConcatFrom(parts, NUM_PARTS);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 1);
+            for (const auto& part : parts) {
+                assert(part.Size() == PART_SIZE);
+            }
+            assert(ThrowingMoveObj::GetAliveObjectCount() == 1 + NUM_PARTS * PART_SIZE);
+        }
+        assert(ThrowingMoveObj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test15() {
+    {
+        Obj::ResetCounters();
+        CircularVector<Obj> q;
+        for (int i = 0; i < 4; ++i) {
+            q.EmplaceBack(i);
+        }
+        assert(q.Capacity() == 4);
+        // Очередь "прокручивается" по буферу без реаллокаций
+        for (int i = 4; i < 100; ++i) {
+            assert(q.Front().id == i - 4);
+            q.PopFront();
+            q.EmplaceBack(i);
+            assert(q.Back().id == i);
+        }
+        assert(q.Capacity() == 4 && q.Size() == 4);
+        // Рост 1 -> 2 -> 4 перенёс 1 + 2 элемента
+        assert(Obj::num_moved == 1 + 2);
+        for (int i = 0; i < 4; ++i) {
+            assert(q[i].id == 96 + i);
+        }
+        // Рост из "перевёрнутого" состояния линеаризует кольцо
+        q.PopFront();
+        q.EmplaceBack(100);
+        q.PushFront(Obj{96});
+        assert(q.Size() == 5 && q.Capacity() == 8);
+        for (int i = 0; i < 5; ++i) {
+            assert(q[i].id == 96 + i);
+        }
+        q.PopBack();
+        assert(q.Back().id == 99);
+        assert(Obj::GetAliveObjectCount() == 4);
+        assert(Obj::num_copied == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Добавление собственного элемента при реаллокации безопасно
+        CircularVector<TestObj> q(1);
+        q.PushBack(q[0]);
+        q.PushFront(q[1]);
+        q.PushFront(std::move(q[2]));
+        for (size_t i = 0; i < q.Size(); ++i) {
+            assert(q[i].IsAlive());
+        }
+    }
+    {
+        // Linearize возвращает элементы first, first + 1, ... непрерывно и в логическом порядке
+        const auto check = [](CircularVector<int>& q, int first) {
+            const std::span<int> span = q.Linearize();
+            assert(span.size() == q.Size());
+            for (size_t i = 0; i < span.size(); ++i) {
+                assert(span[i] == first + static_cast<int>(i));
+                assert(&span[i] == &q[i]);
+            }
+        };
+        // Полный буфер: поворот на месте
+        CircularVector<int> q;
+        for (int i = 0; i < 8; ++i) {
+            q.PushBack(i);
+        }
+        q.PopFront();
+        q.PopFront();
+        q.PushBack(8);
+        q.PushBack(9);
+        const int* buffer_before = &q[6];
+        check(q, 2);
+        assert(q.Capacity() == 8 && &q[0] <= buffer_before && buffer_before <= &q[7]);
+
+        // Первый участок помещается в свободное место
+        for (int i = 0; i < 6; ++i) {
+            q.PopFront();
+        }
+        for (int i = 10; i < 14; ++i) {
+            q.PushBack(i);
+        }
+        q.PopBack();
+        check(q, 8);
+        assert(q.Capacity() == 8);
+
+        // Второй участок помещается в свободное место
+        CircularVector<int> r;
+        for (int i = 0; i < 8; ++i) {
+            r.PushBack(i);
+        }
+        for (int i = 0; i < 3; ++i) {
+            r.PopFront();
+        }
+        r.PushBack(8);
+        r.PopFront();
+        check(r, 4);
+        assert(r.Capacity() == 8);
+
+        // Уже непрерывные элементы не перемещаются
+        const int* front = &r[0];
+        assert(r.Linearize().data() == front);
+
+        // Копия сохраняет логический порядок
+        r.PushFront(3);
+        r.PushBack(9);
+        const CircularVector<int> r_copy(r);
+        for (int i = 0; i < 7; ++i) {
+            assert(r_copy[i] == 3 + i);
+        }
+    }
+    {
+        // Ни один участок не помещается: линеаризация через новый буфер той же ёмкости
+        CircularVector<std::string> q;
+        for (int i = 0; i < 8; ++i) {
+            q.PushBack(std::to_string(i));
+        }
+        for (int i = 0; i < 4; ++i) {
+            q.PopFront();
+        }
+        for (int i = 8; i < 11; ++i) {
+            q.PushBack(std::to_string(i));
+        }
+        const std::span<std::string> span = q.Linearize();
+        assert(q.Capacity() == 8 && span.size() == 7);
+        for (int i = 0; i < 7; ++i) {
+            assert(span[i] == std::to_string(4 + i));
+        }
+    }
+}
+
+constexpr bool ConstexprAppendTest() {
+    Vector<int> v;
+    v.AppendN(5, [](size_t i) {
+        return static_cast<int>(i * i);
+    });
+    {
+        auto inserter = v.UncheckedInserter(2);
+        inserter.PushBack(25);
+        inserter.Emplace(36);
+    }
+    if (v.Size() != 7) {
+        return false;
+    }
+    for (size_t i = 0; i < v.Size(); ++i) {
+        if (v[i] != static_cast<int>(i * i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(ConstexprAppendTest());
+
+void Test16() {
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.EmplaceBack(-1);
+        v.AppendN(10, [](size_t i) {
+            return Obj(static_cast<int>(i));
+        });
+        assert(v.Size() == 11 && v.Capacity() == 11);
+        for (int i = 0; i < 10; ++i) {
+            assert(v[i + 1].id == i);
+        }
+        // Генератор без аргумента; ёмкость растёт не меньше чем вдвое
+        int next_id = 10;
+        v.AppendN(2, [&next_id] {
+            return Obj(next_id++);
+        });
+        assert(v.Size() == 13 && v.Capacity() == 22);
+        assert(v[12].id == 11);
+        assert(Obj::num_copied == 0);
+        // Исключение в генераторе: добавленные в этом вызове элементы уничтожаются
+        const int alive_before = Obj::GetAliveObjectCount();
+        try {
+            v.AppendN(5, [](size_t i) {
+                if (i == 3) {
+                    throw std::runtime_error("Oops");
+                }
+                return Obj(100);
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 13 && v.Capacity() == 22);
+        assert(Obj::GetAliveObjectCount() == alive_before);
+        // Исключение в конструкторе T
+        Obj::default_construction_throw_countdown = 4;
+        try {
+            v.AppendN(5, [] {
+                return Obj();
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 13 && Obj::GetAliveObjectCount() == alive_before);
+        v.AppendN(0, [](size_t) -> Obj {
+            assert(false);
+            return Obj();
+        });
+        assert(v.Size() == 13);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.EmplaceBack(0);
+        {
+            // Ёмкость растёт до Size() + count, но не меньше чем вдвое
+            auto inserter = v.UncheckedInserter(5);
+            assert(v.Capacity() == 6);
+            assert(inserter.Remaining() == 5);
+            inserter.Emplace(1);
+            inserter.PushBack(Obj(2));
+            Obj obj(3);
+            inserter.PushBack(obj);
+            assert(inserter.Remaining() == 2);
+        }
+        assert(v.Size() == 4 && v.Capacity() == 6);
+        const Obj* data = v.begin();
+        for (int i = 0; i < 4; ++i) {
+            assert(v[i].id == i);
+        }
+        // Элементы, созданные до исключения, остаются в векторе
+        try {
+            auto inserter = v.UncheckedInserter(2);
+            inserter.Emplace(4);
+            Obj::default_construction_throw_countdown = 1;
+            inserter.Emplace();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 5 && v[4].id == 4);
+        {
+            // Вставщик ограничен count, а не свободной ёмкостью
+            auto inserter = v.UncheckedInserter(0);
+            assert(inserter.Remaining() == 0);
+        }
+        {
+            // Вставщик, ничего не добавивший, не меняет вектор
+            auto inserter = v.UncheckedInserter(1);
+            assert(inserter.Remaining() == 1);
+        }
+        assert(v.Size() == 5 && v.begin() == data);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<std::string, uint32_t> v;
+        v.AppendN(3, [](size_t i) {
+            return std::string(i + 1, 'a');
+        });
+        v.UncheckedInserter(1).Emplace(4, 'b');
+        assert(v.Size() == 4 && v[2] == "aaa" && v[3] == "bbbb");
+    }
+}
+
+void Test17() {
+    for (size_t num_threads : {1, 2, 4}) {
+        ThreadPool pool(num_threads);
+        assert(pool.NumThreads() == num_threads);
+        {
+            // Каждая задача выполняется ровно один раз
+            Vector<std::atomic<int>> hits(1000);
+            pool.Run(hits.Size(), [&](size_t i) {
+                ++hits[i];
+            });
+            assert(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) {
+                return hit == 1;
+            }));
+        }
+        {
+            // Run изнутри задачи
+            std::atomic<size_t> total = 0;
+            pool.Run(8, [&](size_t i) {
+                pool.Run(i, [&](size_t) {
+                    ++total;
+                });
+            });
+            assert(total == 28);
+        }
+        try {
+            pool.Run(100, [](size_t i) {
+                if (i == 42) {
+                    throw std::runtime_error("Oops");
+                }
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        const size_t SIZE = 300'001;
+        Vector<int64_t> v(SIZE);
+        std::iota(v.begin(), v.end(), 0);
+        ParallelForEach(pool, v, [](int64_t& x) {
+            x *= 2;
+        });
+        assert(v[SIZE - 1] == 2 * int64_t{SIZE - 1});
+        assert(ParallelReduce(pool, v, int64_t{0}) == int64_t{SIZE} * (SIZE - 1));
+        // Некоммутативная операция: порядок элементов сохраняется
+        Vector<std::string> words(5000);
+        for (size_t i = 0; i < words.Size(); ++i) {
+            words[i] = std::to_string(i % 10);
+        }
+        const std::string joined = ParallelReduce(pool, words, std::string(">"));
+        assert(joined.size() == words.Size() + 1);
+        for (size_t i = 0; i < words.Size(); ++i) {
+            assert(joined[i + 1] == '0' + static_cast<char>(i % 10));
+        }
+
+        // Разнородные операции: сумма длин строк и подсчёт элементов по условию
+        const size_t total_length = ParallelTransformReduce(pool, words, size_t{0}, std::plus<>(),
+                                                            [](const std::string& word) {
+                                                                return word.size();
+                                                            });
+        assert(total_length == words.Size());
+        const size_t multiples_of_three = ParallelTransformReduce(pool, v, size_t{0}, std::plus<>(),
+                                                                  [](int64_t x) -> size_t {
+                                                                      return x % 3 == 0;
+                                                                  });
+        assert(multiples_of_three == (SIZE + 2) / 3);
+
+        Vector<double> halves(SIZE);
+        ParallelTransform(pool, v, halves, [](int64_t x) {
+            return x / 2.0;
+        });
+        for (size_t i = 0; i < SIZE; i += 997) {
+            assert(halves[i] == static_cast<double>(i));
+        }
+        Vector<double> wrong_size(SIZE - 1);
+        try {
+            ParallelTransform(pool, v, wrong_size, [](int64_t x) {
+                return x / 2.0;
+            });
+            assert(false);
+        } catch (const std::invalid_argument&) {
+        }
+
+        Vector<uint32_t> keys(SIZE);
+        uint32_t state = 12345;
+        for (uint32_t& key : keys) {
+            state = state * 1664525u + 1013904223u;
+            key = state >> 8;
+        }
+        std::vector<uint32_t> expected(keys.begin(), keys.end());
+        std::sort(expected.begin(), expected.end());
+        ParallelSort(pool, keys);
+        assert(std::equal(keys.begin(), keys.end(), expected.begin(), expected.end()));
+        ParallelSort(pool, keys, std::greater<>());
+        assert(std::equal(keys.begin(), keys.end(), expected.rbegin(), expected.rend()));
+        Vector<int> empty;
+        ParallelSort(pool, empty);
+        assert(ParallelReduce(pool, empty, 7) == 7);
+    }
+    {
+        // Внутренние границы участков начинают кэш-линию
+        Vector<int32_t> v(1'000'000);
+        for (size_t offset : {0, 1, 5}) {
+            const int32_t* data = v.begin() + offset;
+            const size_t size = v.Size() - offset;
+            const Vector<size_t> bounds = parallel_detail::ChunkBounds(data, size, 4);
+            assert(bounds.Size() == 4 * parallel_detail::CHUNKS_PER_THREAD + 1);
+            assert(bounds[0] == 0 && bounds[bounds.Size() - 1] == size);
+            for (size_t i = 1; i + 1 < bounds.Size(); ++i) {
+                assert(bounds[i - 1] < bounds[i]);
+                assert(reinterpret_cast<uintptr_t>(data + bounds[i]) % parallel_detail::CACHE_LINE_SIZE == 0);
+            }
+        }
+        // Небольшой диапазон - один участок
+        const Vector<size_t> bounds = parallel_detail::ChunkBounds(v.begin(), 100, 4);
+        assert(bounds.Size() == 2 && bounds[1] == 100);
+    }
+}
+
+void Test18() {
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.Capacity() == 16);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == 16);
+        assert(Obj::GetAliveObjectCount() == 0);
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Ёмкость меньше двух размеров не считается избыточной при ratio = 4
+        bool trimmed = v.TrimIfSlack(4.0);
+        assert(!trimmed);
+        trimmed = v.TrimIfSlack(2.0);
+        assert(trimmed);
+        assert(v.Size() == 5 && v.Capacity() == 5);
+        trimmed = v.TrimIfSlack(1.0);
+        assert(!trimmed);
+        for (int i = 0; i < 5; ++i) {
+            assert(v[i].id == i);
+        }
+        v.PopBack();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 4 && v[3].id == 3);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0 && v.begin() == nullptr);
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(Obj::num_copied == 0);
+    }
+    {
+        // Бросающий копирующий конструктор: строгая гарантия, как у Reserve
+        ThrowingMoveObj::ResetCounters();
+        Vector<ThrowingMoveObj> v;
+        v.Reserve(4);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v[1].throw_on_copy = true;
+        try {
+            v.ShrinkToFit();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v.Capacity() == 4 && v[0].id == 1 && v[1].id == 2);
+    }
+    {
+        Vector<int, HeapCapacity<>> v(100);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10);
+    }
+    {
+        auto& registry = VectorTrimRegistry::Instance();
+        const size_t registered_before = registry.Size();
+        const size_t SIZE = 64 << 20;
+        Vector<char> peak;
+        peak.Resize(SIZE);
+        std::fill(peak.begin(), peak.end(), 'x');
+        peak.Clear();
+        Vector<int> busy(100);
+        {
+            VectorTrimRegistry::Handle peak_handle = registry.Register(peak);
+            VectorTrimRegistry::Handle busy_handle = registry.Register(busy, 2.0);
+            assert(registry.Size() == registered_before + 2);
+
+            const size_t rss_before = VectorTrimRegistry::CurrentRss();
+            // Порог выше текущего потребления: ничего не ужимается
+            const size_t freed_below_limit = registry.TrimIfRssAbove(rss_before + (SIZE << 4));
+            assert(freed_below_limit == 0);
+            assert(peak.Capacity() == SIZE);
+            const size_t freed = registry.TrimIfRssAbove(rss_before / 2);
+            const size_t rss_after = VectorTrimRegistry::CurrentRss();
+            assert(freed == SIZE);
+            assert(peak.Capacity() == 0 && busy.Capacity() == 100);
+            std::cerr << "Trimming a cleared "sv << (SIZE >> 20) << " MiB Vector: RSS "sv << (rss_before >> 20)
+                      << " MiB -> "sv << (rss_after >> 20) << " MiB"sv << std::endl;
+            if (rss_before != 0) {
+                assert(rss_before - rss_after >= SIZE / 2);
+            }
+
+            // Перемещённый Handle продолжает держать регистрацию
+            VectorTrimRegistry::Handle moved = std::move(busy_handle);
+            assert(!busy_handle.IsRegistered() && moved.IsRegistered());
+            moved.Reset();
+            assert(registry.Size() == registered_before + 1);
+        }
+        assert(registry.Size() == registered_before);
+    }
+}
+
+struct Pod {
+    int32_t id;
+    float weight;
+    char tag[8];
+};
+
+void Test19() {
+    static_assert(std::is_trivially_copyable_v<Pod>);
+    const auto make = [](size_t size, int32_t first_id) {
+        Vector<Pod> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = Pod{first_id + static_cast<int32_t>(i), 0.5f, "pod"};
+        }
+        return v;
+    };
+    const auto check = [](const Vector<Pod>& v, size_t size, int32_t first_id) {
+        assert(v.Size() == size);
+        for (size_t i = 0; i < size; ++i) {
+            assert(v[i].id == first_id + static_cast<int32_t>(i) && v[i].weight == 0.5f);
+            assert(std::string_view(v[i].tag) == "pod");
+        }
+    };
+    const Vector<Pod> source = make(100, 1);
+    const Vector<Pod> copy(source);
+    check(copy, 100, 1);
+    assert(copy.Capacity() == 100);
+
+    // Присваивание в достаточную ёмкость не выделяет память
+    Vector<Pod> v = make(10, 1000);
+    v.Reserve(200);
+    const Pod* buffer = v.begin();
+    v = source;
+    check(v, 100, 1);
+    assert(v.begin() == buffer && v.Capacity() == 200);
+    const Vector<Pod> shorter = make(3, 7);
+    v = shorter;
+    check(v, 3, 7);
+    assert(v.begin() == buffer);
+    // Нехватка ёмкости - новый буфер
+    Vector<Pod> small = make(2, 0);
+    small = source;
+    check(small, 100, 1);
+    const Vector<Pod> empty;
+    v = empty;
+    assert(v.Size() == 0 && v.Capacity() == 200);
+
+    Vector<int, uint32_t> ints(1000);
+    std::iota(ints.begin(), ints.end(), 0);
+    Vector<int, uint32_t> ints_copy(10);
+    ints_copy.Reserve(1000);
+    ints_copy = ints;
+    assert(std::equal(ints.begin(), ints.end(), ints_copy.begin(), ints_copy.end()));
+}
+
+void Test20() {
+    {
+        JaggedVector<int> rows;
+        assert(rows.RowCount() == 0 && rows.ValueCount() == 0);
+        size_t row = rows.AppendRow({1, 2, 3});
+        assert(row == 0);
+        row = rows.AppendRow(std::vector<int>{});
+        assert(row == 1);
+        const std::array<int, 2> pair = {4, 5};
+        row = rows.AppendRow(pair);
+        assert(row == 2);
+        assert(rows.RowCount() == 3 && rows.ValueCount() == 5);
+        assert(rows.RowSize(0) == 3 && rows.RowSize(1) == 0 && rows[2][1] == 5);
+        rows[0][0] = 10;
+        assert(rows.Values()[0] == 10);
+
+        // Строки из плоского представления
+        const std::array<size_t, 3> sizes = {2, 0, 1};
+        const std::array<int, 3> values = {6, 7, 8};
+        rows.AppendRows(sizes, values);
+        assert(rows.RowCount() == 6 && rows[3][1] == 7 && rows.RowSize(4) == 0 && rows[5][0] == 8);
+        try {
+            rows.AppendRows(sizes, pair);
+            assert(false);
+        } catch (const std::invalid_argument&) {
+        }
+        assert(rows.RowCount() == 6 && rows.ValueCount() == 8);
+
+        // Удаление строк не меняет номера до Compact
+        rows.EraseRow(0);
+        rows.EraseRow(3);
+        rows.EraseRow(3);
+        assert(rows.ErasedRowCount() == 2 && rows.IsErased(3) && !rows.IsErased(2));
+        assert(rows.RowCount() == 6 && rows[2][0] == 4);
+
+        JaggedVector<int> live;
+        live.AppendRow({-1});
+        live.AppendRows(rows);
+        assert(live.RowCount() == 5 && live.ValueCount() == 4);
+        assert(live[2][0] == 4 && live[4][0] == 8);
+
+        rows.Compact();
+        assert(rows.RowCount() == 4 && rows.ErasedRowCount() == 0 && rows.ValueCount() == 3);
+        assert(rows.RowSize(0) == 0 && rows[1][0] == 4 && rows[1][1] == 5 && rows.RowSize(2) == 0);
+        assert(rows[3][0] == 8);
+
+        JaggedVector<int> moved(std::move(rows));
+        assert(moved.RowCount() == 4 && rows.RowCount() == 0);
+        rows.AppendRow({1});
+        assert(rows.RowCount() == 1 && rows[0][0] == 1);
+        moved.Clear();
+        assert(moved.RowCount() == 0 && moved.ValueCount() == 0);
+    }
+    {
+        // Повторные AppendRows растят буферы геометрически: реаллокаций O(log n), а не n
+        const size_t NUM_CALLS = 10'000;
+        const std::array<size_t, 1> sizes = {1};
+        const std::array<int, 1> values = {7};
+        JaggedVector<int> one_row;
+        one_row.AppendRow(values);
+        JaggedVector<int> flat;
+        JaggedVector<int> copied;
+        size_t reallocations = 0;
+        for (size_t i = 0; i < NUM_CALLS; ++i) {
+            const size_t flat_rows = flat.RowCapacity();
+            const size_t copied_rows = copied.RowCapacity();
+            const size_t copied_values = copied.ValueCapacity();
+            flat.AppendRows(sizes, values);
+            copied.AppendRows(one_row);
+            reallocations += (flat.RowCapacity() != flat_rows) + (copied.RowCapacity() != copied_rows)
+                             + (copied.ValueCapacity() != copied_values);
+        }
+        assert(flat.RowCount() == NUM_CALLS && copied.RowCount() == NUM_CALLS);
+        assert(flat[NUM_CALLS - 1][0] == 7 && copied[NUM_CALLS - 1][0] == 7);
+        assert(reallocations <= 3 * 15);
+    }
+    {
+        // Исключение при добавлении строки оставляет JaggedVector прежним
+        Obj::ResetCounters();
+        JaggedVector<Obj> rows;
+        Vector<Obj> row;
+        row.EmplaceBack(1);
+        row.EmplaceBack(2);
+        rows.AppendRow(row);
+        row[1].throw_on_copy = true;
+        try {
+            rows.AppendRow(row);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(rows.RowCount() == 1 && rows.ValueCount() == 2);
+        rows.EraseRow(0);
+        rows.AppendRow(std::span<const Obj>(row.begin(), 1));
+        rows.Compact();
+        assert(rows.RowCount() == 1 && rows.ValueCount() == 1 && rows[0][0].id == 1);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        JaggedVector<std::string> words;
+        words.AppendRow(std::array<std::string_view, 2>{"ab", "c"});
+        words.AppendRow({"d"});
+        words.EraseRow(0);
+        words.Compact();
+        assert(words.RowCount() == 1 && words[0][0] == "d" && words.ValueCount() == 1);
+    }
+    {
+        // Добавление собственных элементов, когда буфер при этом переносится
+        JaggedVector<std::string> rows;
+        rows.AppendRow({"ab", "cd", "ef"});
+        assert(rows.ValueCapacity() == 3);
+        rows.AppendRow(rows[0]);
+        assert(rows.RowCount() == 2 && rows.ValueCapacity() > 3);
+        assert(rows[1][0] == "ab" && rows[1][2] == "ef" && rows[0][1] == "cd");
+        const std::array<size_t, 2> sizes = {2, 4};
+        rows.AppendRows(sizes, rows.Values());
+        assert(rows.RowCount() == 4 && rows.ValueCount() == 12);
+        assert(rows[2][0] == "ab" && rows[2][1] == "cd" && rows[3][0] == "ef" && rows[3][3] == "ef");
+        // Часть строки из середины буфера
+        rows.AppendRow(rows[3].subspan(1, 2));
+        assert(rows.RowSize(4) == 2 && rows[4][0] == "ab" && rows[4][1] == "cd");
+    }
+}
+
 struct C {
     C() noexcept {
         ++def_ctor;
@@ -639,7 +2107,318 @@ void Benchmark() {
     }
 }
 
+void BenchmarkSnapshot() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 1'000'000;
+    const int NUM_SNAPSHOTS = 100;
+
+    Vector<int> v(SIZE);
+    auto start = steady_clock::now();
+    for (int i = 0; i < NUM_SNAPSHOTS; ++i) {
+        Vector<int> snapshot(v);
+        v[i] = snapshot[i] + 1;
+    }
+    const auto deep_copy = duration_cast<microseconds>(steady_clock::now() - start) / NUM_SNAPSHOTS;
+
+    SharedVector<int> shared(SIZE);
+    start = steady_clock::now();
+    for (int i = 0; i < NUM_SNAPSHOTS; ++i) {
+        SharedVector<int> snapshot(shared);
+        shared.PushBack(static_cast<int>(snapshot.Size()));
+        snapshot = SharedVector<int>();
+        shared.PushBack(i);
+    }
+    const auto cow_with_detach = duration_cast<microseconds>(steady_clock::now() - start) / NUM_SNAPSHOTS;
+
+    start = steady_clock::now();
+    size_t total = 0;
+    for (int i = 0; i < NUM_SNAPSHOTS; ++i) {
+        SharedVector<int> snapshot(shared);
+        total += snapshot.Size();
+    }
+    const auto snapshot_only = duration_cast<nanoseconds>(steady_clock::now() - start) / NUM_SNAPSHOTS;
+
+    cerr << "Snapshot of "sv << SIZE << " ints: Vector copy "sv << deep_copy.count() << " us"sv
+         << ", SharedVector snapshot "sv << snapshot_only.count() << " ns"sv
+         << ", snapshot + write by owner "sv << cow_with_detach.count() << " us"sv
+         << " ("sv << total / NUM_SNAPSHOTS << ')' << endl;
+}
+
+template <typename SizeType>
+void BenchmarkNestedVector(std::string_view name) {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_ROWS = 1'000'000;
+    const size_t ROW_SIZE = 4;
+
+    Vector<Vector<int, SizeType>, SizeType> rows;
+    rows.Reserve(NUM_ROWS);
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        rows.EmplaceBack(ROW_SIZE)[0] = static_cast<int>(i);
+    }
+    // Память без учёта служебных данных аллокатора и заголовков HeapCapacity: дескрипторы строк и их элементы
+    const size_t header_bytes = rows.Capacity() * sizeof(Vector<int, SizeType>);
+    const size_t payload_bytes = NUM_ROWS * ROW_SIZE * sizeof(int);
+
+    const auto start = steady_clock::now();
+    long long sum = 0;
+    for (int pass = 0; pass < 10; ++pass) {
+        for (const auto& row : rows) {
+            for (const int value : row) {
+                sum += value;
+            }
+        }
+    }
+    const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+    cerr << "Vector<Vector<int>> "sv << name << ": handle "sv << sizeof(Vector<int, SizeType>) << " bytes, headers "sv
+         << header_bytes / 1024 << " KiB, payload "sv << payload_bytes / 1024 << " KiB, 10 scans "sv
+         << elapsed.count() << " ms ("sv << sum << ')' << endl;
+}
+
+template <typename Relocation>
+void BenchmarkRelocationPolicy(std::string_view name) {
+    using namespace std;
+    using namespace std::chrono;
+    const int NUM = 1'000'000;
+
+    ThrowingMoveObj::ResetCounters();
+    const auto start = steady_clock::now();
+    {
+        Vector<ThrowingMoveObj, size_t, Relocation> v;
+        for (int i = 0; i < NUM; ++i) {
+            v.EmplaceBack(i);
+        }
+    }
+    const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+    cerr << "EmplaceBack of "sv << NUM << " ThrowingMoveObj, "sv << name << ": "sv << elapsed.count() << " ms, "sv
+         << ThrowingMoveObj::num_copied << " copies, "sv << ThrowingMoveObj::num_moved << " moves"sv << endl;
+}
+
+template <typename Container>
+void BenchmarkPushLatency(std::string_view name) {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM = 8'000'000;
+
+    std::vector<uint32_t> latencies(NUM);
+    {
+        Container v;
+        for (size_t i = 0; i < NUM; ++i) {
+            const auto start = steady_clock::now();
+            v.PushBack(static_cast<int>(i));
+            latencies[i] = static_cast<uint32_t>(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    cerr << "PushBack latency, "sv << name << ": p50 "sv << percentile(0.5) << " ns, p99 "sv << percentile(0.99)
+         << " ns, p99.9 "sv << percentile(0.999) << " ns, max "sv << latencies.back() / 1000 << " us"sv << endl;
+}
+
+void BenchmarkQueueDrain() {
+    using namespace std;
+    using namespace std::chrono;
+    const int NUM = 50'000;
+
+    Vector<int> v;
+    CircularVector<int> q;
+    for (int i = 0; i < NUM; ++i) {
+        v.PushBack(i);
+        q.PushBack(i);
+    }
+    long long sum = 0;
+    auto start = steady_clock::now();
+    while (v.Size() != 0) {
+        sum += *v.begin();
+        v.Erase(v.begin());
+    }
+    const auto vector_time = duration_cast<microseconds>(steady_clock::now() - start);
+    start = steady_clock::now();
+    while (q.Size() != 0) {
+        sum += q.Front();
+        q.PopFront();
+    }
+    const auto circular_time = duration_cast<microseconds>(steady_clock::now() - start);
+    cerr << "Draining "sv << NUM << " ints as FIFO: Vector::Erase(begin()) "sv << vector_time.count()
+         << " us, CircularVector::PopFront "sv << circular_time.count() << " us ("sv << sum << ')' << endl;
+}
+
+void BenchmarkAppend() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM = 10'000'000;
+
+    const auto measure = [](string_view name, auto fill) {
+        Vector<int> v;
+        const auto start = steady_clock::now();
+        fill(v);
+        const auto time = duration_cast<microseconds>(steady_clock::now() - start);
+        cerr << "Filling "sv << v.Size() << " ints with "sv << name << ": "sv << time.count() << " us ("sv
+             << v[v.Size() / 2] << ')' << endl;
+    };
+    measure("PushBack"sv, [&](Vector<int>& v) {
+        for (size_t i = 0; i < NUM; ++i) {
+            v.PushBack(static_cast<int>(i * 3));
+        }
+    });
+    measure("Reserve + PushBack"sv, [&](Vector<int>& v) {
+        v.Reserve(NUM);
+        for (size_t i = 0; i < NUM; ++i) {
+            v.PushBack(static_cast<int>(i * 3));
+        }
+    });
+    measure("AppendN"sv, [&](Vector<int>& v) {
+        v.AppendN(NUM, [](size_t i) {
+            return static_cast<int>(i * 3);
+        });
+    });
+    measure("UncheckedInserter"sv, [&](Vector<int>& v) {
+        auto inserter = v.UncheckedInserter(NUM);
+        for (size_t i = 0; i < NUM; ++i) {
+            inserter.PushBack(static_cast<int>(i * 3));
+        }
+    });
+}
+
+void BenchmarkParallelScaling() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM = 8'000'000;
+
+    Vector<double> values(NUM);
+    std::iota(values.begin(), values.end(), 1.0);
+    Vector<uint32_t> keys(NUM);
+    uint32_t state = 1;
+    for (uint32_t& key : keys) {
+        state = state * 1664525u + 1013904223u;
+        key = state;
+    }
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    // 1, 2, 4, ... и число ядер
+    Vector<size_t> thread_counts;
+    for (size_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+        thread_counts.PushBack(num_threads);
+    }
+    thread_counts.PushBack(max_threads);
+    for (size_t num_threads : thread_counts) {
+        ThreadPool pool(num_threads);
+        Vector<double> roots(NUM);
+        auto start = steady_clock::now();
+        ParallelTransform(pool, values, roots, [](double x) {
+            return std::sqrt(x);
+        });
+        const auto transform_time = duration_cast<microseconds>(steady_clock::now() - start);
+        start = steady_clock::now();
+        const double sum = ParallelReduce(pool, roots, 0.0);
+        const auto reduce_time = duration_cast<microseconds>(steady_clock::now() - start);
+        Vector<uint32_t> sorted(keys);
+        start = steady_clock::now();
+        ParallelSort(pool, sorted);
+        const auto sort_time = duration_cast<microseconds>(steady_clock::now() - start);
+        cerr << "Parallel algorithms over "sv << NUM << " elements, "sv << num_threads << " threads: Transform "sv
+             << transform_time.count() << " us, Reduce "sv << reduce_time.count() << " us, Sort "sv
+             << sort_time.count() << " us ("sv << static_cast<long long>(sum) << ')' << endl;
+    }
+}
+
+template <typename T>
+void BenchmarkCopyForType(std::string_view name) {
+    using namespace std;
+    using namespace std::chrono;
+    // До 10M элементов вместо 100M, чтобы уложиться в память тестовых машин
+    for (size_t size : {size_t{1'000}, size_t{100'000}, size_t{10'000'000}}) {
+        const size_t repeats = std::max<size_t>(1, 100'000'000 / size / 10);
+        Vector<T> source(size);
+        const vector<T> std_source(size);
+        Vector<T> target(size);
+        vector<T> std_target(size);
+
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i) {
+            Vector<T> copy(source);
+            target.Swap(copy);
+        }
+        const auto construct_time = duration_cast<nanoseconds>(steady_clock::now() - start) / repeats;
+        start = steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i) {
+            vector<T> copy(std_source);
+            std_target.swap(copy);
+        }
+        const auto std_construct_time = duration_cast<nanoseconds>(steady_clock::now() - start) / repeats;
+        start = steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i) {
+            target = source;
+        }
+        const auto assign_time = duration_cast<nanoseconds>(steady_clock::now() - start) / repeats;
+        start = steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i) {
+            std_target = std_source;
+        }
+        const auto std_assign_time = duration_cast<nanoseconds>(steady_clock::now() - start) / repeats;
+        cerr << "Copying "sv << size << ' ' << name << ": construct Vector "sv << construct_time.count()
+             << " ns, std::vector "sv << std_construct_time.count() << " ns; assign Vector "sv
+             << assign_time.count() << " ns, std::vector "sv << std_assign_time.count() << " ns"sv << endl;
+    }
+}
+
+void BenchmarkCopy() {
+    BenchmarkCopyForType<int>("int");
+    BenchmarkCopyForType<Pod>("Pod");
+}
+
+void BenchmarkJagged() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_ROWS = 1'000'000;
+    // Длины строк 0..7, как у множества мелких внутренних векторов
+    const auto row_size = [](size_t row) {
+        return (row * 2654435761u >> 7) % 8;
+    };
+    const std::array<int, 8> row_values = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    auto start = steady_clock::now();
+    Vector<Vector<int>> nested;
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        Vector<int>& inner = nested.EmplaceBack();
+        for (size_t i = 0; i < row_size(row); ++i) {
+            inner.PushBack(row_values[i]);
+        }
+    }
+    const auto nested_build = duration_cast<microseconds>(steady_clock::now() - start);
+    start = steady_clock::now();
+    JaggedVector<int> jagged;
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        jagged.AppendRow(std::span<const int>(row_values.data(), row_size(row)));
+    }
+    const auto jagged_build = duration_cast<microseconds>(steady_clock::now() - start);
+
+    long long nested_sum = 0;
+    start = steady_clock::now();
+    for (const Vector<int>& inner : nested) {
+        for (int value : inner) {
+            nested_sum += value;
+        }
+    }
+    const auto nested_scan = duration_cast<microseconds>(steady_clock::now() - start);
+    long long jagged_sum = 0;
+    start = steady_clock::now();
+    for (size_t row = 0; row < jagged.RowCount(); ++row) {
+        for (int value : jagged[row]) {
+            jagged_sum += value;
+        }
+    }
+    const auto jagged_scan = duration_cast<microseconds>(steady_clock::now() - start);
+    cerr << NUM_ROWS << " rows: build Vector<Vector<int>> "sv << nested_build.count() << " us, JaggedVector "sv
+         << jagged_build.count() << " us; scan Vector<Vector<int>> "sv << nested_scan.count()
+         << " us, JaggedVector "sv << jagged_scan.count() << " us ("sv << nested_sum << ", "sv
+         << jagged_sum << ')' << endl;
+}
+
 int main() {
+    using namespace std::literals;
     try {
         Test1();
         Test2();
@@ -647,8 +2426,38 @@ int main() {
         Test4();
         Test5();
         Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
         Benchmark();
+        BenchmarkSnapshot();
+        BenchmarkNestedVector<size_t>("size_t"sv);
+        BenchmarkNestedVector<uint32_t>("uint32_t"sv);
+        BenchmarkNestedVector<HeapCapacity<>>("HeapCapacity<size_t>"sv);
+        BenchmarkRelocationPolicy<StrongRelocation>("StrongRelocation"sv);
+        BenchmarkRelocationPolicy<FastRelocation>("FastRelocation"sv);
+        BenchmarkPushLatency<Vector<int>>("Vector"sv);
+        BenchmarkPushLatency<IncrementalVector<int>>("IncrementalVector"sv);
+        BenchmarkQueueDrain();
+        BenchmarkAppend();
+        BenchmarkParallelScaling();
+        BenchmarkCopy();
+        BenchmarkJagged();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
+#ifdef VECTOR_PROFILING
+    VectorProfile::Instance().Print(std::cerr);
+#endif
 }
\ No newline at end of file
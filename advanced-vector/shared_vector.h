@@ -0,0 +1,229 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+// Вектор с разделяемым буфером и копированием при записи.
+// Копирование SharedVector стоит O(1): копии ссылаются на общий буфер со счётчиком ссылок.
+// Первая модифицирующая операция над копией, буфер которой разделяется с другими,
+// создаёт собственную копию буфера (Detach).
+// Счётчик ссылок атомарный, поэтому разные объекты SharedVector, разделяющие буфер,
+// можно использовать и уничтожать в разных потоках. Один и тот же объект SharedVector,
+// как и Vector, одновременно из нескольких потоков изменять нельзя.
+//
+// Неконстантные operator[], begin и end выдают ссылки для записи в буфер, поэтому после них
+// буфер перестаёт разделяться: копия такого SharedVector сразу копирует элементы, и запись
+// по ранее выданной ссылке не попадает в снимок. Остальные модифицирующие операции снова
+// разрешают разделение и делают выданные ранее ссылки и итераторы недействительными.
+// Для чтения из разделяемой копии используйте константный доступ (std::as_const):
+// неконстантный operator[] отделяет буфер, копируя все элементы за O(n).
+template <typename T>
+class SharedVector {
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SharedVector() = default;
+
+    explicit SharedVector(size_t size)
+        : block_(new Block(Vector<T>(size))) {
+    }
+
+    explicit SharedVector(Vector<T> data)
+        : block_(new Block(std::move(data))) {
+    }
+
+    // O(1), если буфер other разделяемый, иначе копирует элементы
+    SharedVector(const SharedVector& other) {
+        if (other.block_ == nullptr) {
+            return;
+        }
+        if (other.block_->shareable) {
+            block_ = other.block_;
+            block_->ref_count.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            block_ = new Block(Vector<T>(other.block_->data));
+        }
+    }
+
+    SharedVector(SharedVector&& other) noexcept {
+        Swap(other);
+    }
+
+    SharedVector& operator=(const SharedVector& rhs) {
+        if (this != &rhs) {
+            SharedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SharedVector& operator=(SharedVector&& rhs) noexcept {
+        Swap(rhs);
+        return *this;
+    }
+
+    ~SharedVector() {
+        Release();
+    }
+
+    void Swap(SharedVector& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+    // Немодифицирующие операции не отделяют буфер
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->data.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->data.Capacity() : 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->data[index];
+    }
+
+    const_iterator begin() const noexcept {
+        return block_ != nullptr ? block_->data.begin() : nullptr;
+    }
+    const_iterator end() const noexcept {
+        return block_ != nullptr ? block_->data.end() : nullptr;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Количество объектов SharedVector, ссылающихся на тот же буфер
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->ref_count.load(std::memory_order_acquire) : 0;
+    }
+
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    // Модифицирующие операции: перед изменением буфер становится единоличным.
+    // Если при отделении буфера выбрасывается исключение, SharedVector не изменяется
+
+    // Доступ для записи: буфер не разделяется, пока не будет вызвана другая модифицирующая операция
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return DetachForWrite()[index];
+    }
+
+    iterator begin() {
+        return DetachForWrite().begin();
+    }
+    iterator end() {
+        return DetachForWrite().end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        Detach(new_capacity).Reserve(new_capacity);
+    }
+
+    void Resize(size_t new_size) {
+        Detach(new_size).Resize(new_size);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        assert(Size() != 0);
+        Detach().PopBack();
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // Аргументы могут ссылаться на элементы разделяемого буфера: при отделении
+        // старый буфер остаётся жив благодаря другим владельцам, поэтому ссылки не висят
+        return Detach(GrownCapacity(Size() + 1)).EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = pos - cbegin();
+        Vector<T>& data = Detach(GrownCapacity(Size() + 1));
+        return data.Emplace(data.cbegin() + index, std::forward<Args>(args)...);
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = pos - cbegin();
+        Vector<T>& data = Detach();
+        return data.Erase(data.cbegin() + index);
+    }
+
+private:
+    struct Block {
+        explicit Block(Vector<T> data)
+            : data(std::move(data)) {
+        }
+
+        std::atomic<size_t> ref_count = 1;
+        // false, пока у владельца могут оставаться ссылки для записи в data.
+        // Меняется только единоличным владельцем, поэтому не требует атомарности
+        bool shareable = true;
+        Vector<T> data;
+    };
+
+    // Ёмкость для добавления элементов до required: как при реаллокации Vector,
+    // нехватка ёмкости увеличивает её не меньше чем вдвое
+    size_t GrownCapacity(size_t required) const noexcept {
+        return required <= Capacity() ? required : std::max(required, Size() * 2);
+    }
+
+    // Делает буфер единоличным и возвращает его. min_capacity - ёмкость, которая понадобится
+    // вызывающей операции: копия сразу выделяется с ёмкостью не меньше min_capacity и не меньше
+    // разделяемой, чтобы не перевыделять память дважды. Запас сверх min_capacity не добавляется,
+    // поэтому Reserve и Resize дают ту же ёмкость, что и у Vector
+    Vector<T>& Detach(size_t min_capacity = 0) {
+        if (block_ == nullptr) {
+            block_ = new Block(Vector<T>());
+        } else if (block_->ref_count.load(std::memory_order_acquire) != 1) {
+            const Vector<T>& shared = block_->data;
+            Block* own = new Block(Vector<T>(shared, std::max(min_capacity, shared.Capacity())));
+            Release();
+            block_ = own;
+        }
+        block_->shareable = true;
+        return block_->data;
+    }
+
+    Vector<T>& DetachForWrite() {
+        Vector<T>& data = Detach();
+        block_->shareable = false;
+        return data;
+    }
+
+    void Release() noexcept {
+        if (block_ != nullptr && block_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block_;
+        }
+        block_ = nullptr;
+    }
+
+    Block* block_ = nullptr;
+};
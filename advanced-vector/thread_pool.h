@@ -0,0 +1,231 @@
+#pragma once
+#include "circular_vector.h"
+#include "vector.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Пул потоков с перехватом работы (work stealing).
+// У каждого рабочего потока своя очередь задач: поток берёт задачи с её конца,
+// а освободившиеся потоки забирают задачи с начала чужих очередей.
+// Задачи пакета Run раздаются очередям непрерывными блоками, поэтому при равномерной
+// нагрузке каждый поток обрабатывает соседние участки данных, а перехват выравнивает неравномерную.
+//
+// Поток, вызвавший Run, тоже выполняет задачи, поэтому пул из num_threads потоков
+// запускает num_threads - 1 рабочих. Run можно вызывать и изнутри задач.
+class ThreadPool {
+public:
+    // num_threads - общее число потоков вместе с вызывающим Run, 0 - по числу ядер
+    explicit ThreadPool(size_t num_threads = 0) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_queues_ = num_threads - 1;
+        queues_ = std::make_unique<Queue[]>(num_queues_);
+        workers_.Reserve(num_queues_);
+        try {
+            for (size_t i = 0; i + 1 < num_threads; ++i) {
+                workers_.EmplaceBack([this, i] {
+                    WorkerLoop(i);
+                });
+            }
+        } catch (...) {
+            Stop();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        Stop();
+    }
+
+    size_t NumThreads() const noexcept {
+        return num_queues_ + 1;
+    }
+
+    // Выполняет task(i) для всех i из [0, count) и ждёт завершения.
+    // Если задачи выбросили исключения, после завершения пробрасывается первое из них,
+    // а ещё не начатые задачи пакета пропускаются
+    template <typename Task>
+    void Run(size_t count, Task&& task) {
+        if (count == 0) {
+            return;
+        }
+        if (count == 1 || num_queues_ == 0) {
+            for (size_t i = 0; i < count; ++i) {
+                task(i);
+            }
+            return;
+        }
+        Batch batch;
+        batch.run = [](void* context, size_t index) {
+            (*static_cast<std::remove_reference_t<Task>*>(context))(index);
+        };
+        batch.context = std::addressof(task);
+        batch.remaining = count;
+
+        // Счётчик увеличивается до постановки задач, чтобы не уйти ниже нуля,
+        // если рабочий заберёт задачу раньше, чем Run его обновит
+        {
+            std::lock_guard lock(sleep_mutex_);
+            queued_ += count;
+        }
+        const size_t num_queues = num_queues_;
+        size_t pushed = 0;
+        std::exception_ptr push_error;
+        try {
+            for (size_t q = 0; q < num_queues; ++q) {
+                std::lock_guard lock(queues_[q].mutex);
+                for (size_t i = count * q / num_queues; i < count * (q + 1) / num_queues; ++i) {
+                    queues_[q].jobs.PushBack(Job{&batch, i});
+                    ++pushed;
+                }
+            }
+        } catch (...) {
+            // Очередь не смогла вырасти: непоставленные задачи не выполняются, но уже
+            // поставленные нужно дождаться, ведь они ссылаются на batch
+            push_error = std::current_exception();
+            batch.failed = true;
+            queued_ -= count - pushed;
+            if (batch.remaining.fetch_sub(count - pushed) == count - pushed) {
+                batch.done = true;
+            }
+        }
+        sleep_cv_.notify_all();
+
+        // Пока в очередях есть работа, вызывающий поток помогает, затем ждёт последнюю задачу
+        Job job;
+        while (TrySteal(num_queues, job)) {
+            Execute(job);
+        }
+        {
+            std::unique_lock lock(batch.mutex);
+            batch.done_cv.wait(lock, [&batch] {
+                return batch.done;
+            });
+        }
+        if (push_error != nullptr) {
+            std::rethrow_exception(push_error);
+        }
+        if (batch.error != nullptr) {
+            std::rethrow_exception(batch.error);
+        }
+    }
+
+private:
+    // Пакет задач одного вызова Run. Живёт на стеке вызывающего потока
+    struct Batch {
+        void (*run)(void* context, size_t index) = nullptr;
+        void* context = nullptr;
+        std::atomic<size_t> remaining = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+    };
+
+    struct Job {
+        Batch* batch = nullptr;
+        size_t index = 0;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        CircularVector<Job> jobs;
+    };
+
+    static void Execute(const Job& job) noexcept {
+        Batch& batch = *job.batch;
+        if (!batch.failed.load(std::memory_order_relaxed)) {
+            try {
+                batch.run(batch.context, job.index);
+            } catch (...) {
+                std::lock_guard lock(batch.mutex);
+                if (batch.error == nullptr) {
+                    batch.error = std::current_exception();
+                }
+                batch.failed = true;
+            }
+        }
+        if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Уведомление под мьютексом: Run не вернётся и не разрушит batch, пока мьютекс занят
+            std::lock_guard lock(batch.mutex);
+            batch.done = true;
+            batch.done_cv.notify_all();
+        }
+    }
+
+    bool TryPop(size_t queue, Job& job) {
+        std::lock_guard lock(queues_[queue].mutex);
+        if (queues_[queue].jobs.Size() == 0) {
+            return false;
+        }
+        job = queues_[queue].jobs.Back();
+        queues_[queue].jobs.PopBack();
+        --queued_;
+        return true;
+    }
+
+    // Забирает задачу с начала одной из очередей, начиная с очереди first
+    bool TrySteal(size_t first, Job& job) {
+        for (size_t i = 0; i < num_queues_; ++i) {
+            Queue& queue = queues_[(first + i) % num_queues_];
+            std::lock_guard lock(queue.mutex);
+            if (queue.jobs.Size() != 0) {
+                job = queue.jobs.Front();
+                queue.jobs.PopFront();
+                --queued_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index) {
+        Job job;
+        while (true) {
+            if (TryPop(index, job) || TrySteal(index + 1, job)) {
+                Execute(job);
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] {
+                return stop_ || queued_ > 0;
+            });
+            if (stop_ && queued_ == 0) {
+                return;
+            }
+        }
+    }
+
+    void Stop() noexcept {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Очередь i принадлежит рабочему потоку i. Рабочие читают num_queues_, а не workers_.Size():
+    // workers_ ещё заполняется, когда первые рабочие уже запущены
+    size_t num_queues_ = 0;
+    std::unique_ptr<Queue[]> queues_;
+    Vector<std::thread> workers_;
+    // Число задач в очередях: по нему спящие рабочие узнают о новой работе
+    std::atomic<size_t> queued_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// Реестр векторов, которые можно ужать, когда процессу не хватает памяти.
+// Долгоживущий владелец регистрирует вектор и хранит полученный Handle; пока Handle жив,
+// TrimAll вызывает для вектора TrimIfSlack(max_slack_ratio). Разрушение Handle снимает
+// регистрацию и ждёт окончания идущего TrimAll, поэтому Handle следует объявлять после вектора.
+//
+// TrimAll ужимает векторы в вызывающем потоке. Vector не потокобезопасен, поэтому вызывать его
+// нужно там, где зарегистрированные векторы не используются (например, между пакетами работы).
+class VectorTrimRegistry {
+public:
+    class Handle {
+    public:
+        Handle() = default;
+
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        Handle(Handle&& other) noexcept
+            : id_(std::exchange(other.id_, 0)) {
+        }
+
+        Handle& operator=(Handle&& rhs) noexcept {
+            if (this != &rhs) {
+                Reset();
+                id_ = std::exchange(rhs.id_, 0);
+            }
+            return *this;
+        }
+
+        ~Handle() {
+            Reset();
+        }
+
+        // Снимает регистрацию досрочно
+        void Reset() noexcept {
+            if (id_ != 0) {
+                VectorTrimRegistry::Instance().Unregister(id_);
+                id_ = 0;
+            }
+        }
+
+        bool IsRegistered() const noexcept {
+            return id_ != 0;
+        }
+
+    private:
+        friend class VectorTrimRegistry;
+
+        explicit Handle(uint64_t id) noexcept
+            : id_(id) {
+        }
+
+        uint64_t id_ = 0;
+    };
+
+    static VectorTrimRegistry& Instance() {
+        static VectorTrimRegistry registry;
+        return registry;
+    }
+
+    // Вектор не должен разрушаться раньше, чем возвращённый Handle
+    template <typename T, typename... Options>
+    [[nodiscard]] Handle Register(Vector<T, Options...>& vector, double max_slack_ratio = 1.0) {
+        std::lock_guard lock(mutex_);
+        const uint64_t id = ++last_id_;
+        trimmers_.emplace(id, [&vector, max_slack_ratio] {
+            const size_t capacity_before = vector.Capacity();
+            vector.TrimIfSlack(max_slack_ratio);
+            return (capacity_before - vector.Capacity()) * sizeof(T);
+        });
+        return Handle(id);
+    }
+
+    size_t Size() const {
+        std::lock_guard lock(mutex_);
+        return trimmers_.size();
+    }
+
+    // Ужимает все зарегистрированные векторы. Возвращает число освобождённых байт.
+    // Если ужатие вектора выбросит исключение (не хватило памяти на новый буфер),
+    // вектор остаётся прежним, а остальные всё равно ужимаются
+    size_t TrimAll() {
+        std::lock_guard lock(mutex_);
+        size_t freed = 0;
+        for (auto& [id, trim] : trimmers_) {
+            try {
+                freed += trim();
+            } catch (...) {
+            }
+        }
+        return freed;
+    }
+
+    // Ужимает векторы, если резидентная память процесса больше limit_bytes
+    size_t TrimIfRssAbove(size_t limit_bytes) {
+        return CurrentRss() > limit_bytes ? TrimAll() : 0;
+    }
+
+    // Резидентная память процесса в байтах по /proc/self/statm; 0, если её не узнать
+    static size_t CurrentRss() {
+#ifdef __linux__
+        std::ifstream statm("/proc/self/statm");
+        size_t total_pages = 0;
+        size_t resident_pages = 0;
+        if (statm >> total_pages >> resident_pages) {
+            return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0;
+    }
+
+private:
+    VectorTrimRegistry() = default;
+
+    void Unregister(uint64_t id) noexcept {
+        std::lock_guard lock(mutex_);
+        trimmers_.erase(id);
+    }
+
+    mutable std::mutex mutex_;
+    uint64_t last_id_ = 0;
+    std::map<uint64_t, std::function<size_t()>> trimmers_;
+};
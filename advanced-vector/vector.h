@@ -1,28 +1,160 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
 #include <new>
+#include <span>
+#include <stdexcept>
 #include <utility>
 #include <memory>
 #include <iostream>
-template <typename T>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+
+// Профилирование операций по аппаратным счётчикам включается макросом VECTOR_PROFILING
+#ifdef VECTOR_PROFILING
+#include "vector_profiler.h"
+#else
+#define VECTOR_PROFILE_SCOPE(operation)
+#endif
+
+// Политика хранения ёмкости в заголовке динамического блока, а не в самом RawMemory.
+// RawMemory<T, HeapCapacity<S>> состоит из одного указателя, поэтому
+// Vector<T, HeapCapacity<>> занимает 16 байт даже с размером типа size_t.
+// Цена - чтение заголовка из памяти при каждом обращении к Capacity()
+template <typename SizeType = size_t>
+struct HeapCapacity {};
+
+// Целочисленный тип, которым хранятся размер и ёмкость
+template <typename SizeType>
+struct SizeTypeTraits {
+    static_assert(std::is_unsigned_v<SizeType>, "SizeType must be an unsigned integer type");
+    using type = SizeType;
+};
+
+template <typename SizeType>
+struct SizeTypeTraits<HeapCapacity<SizeType>> : SizeTypeTraits<SizeType> {};
+
+template <typename SizeType>
+using SizeTypeOf = typename SizeTypeTraits<SizeType>::type;
+
+template <typename T, typename SizeType = size_t>
 class RawMemory {
+public:
+    constexpr RawMemory() = default;
+
+    constexpr explicit RawMemory(size_t capacity)
+        : buffer_(Allocate(CheckCapacity(capacity)))
+        , capacity_(static_cast<SizeType>(capacity)) {
+    }
+    
+    RawMemory(const RawMemory&) = delete;
+    RawMemory& operator=(const RawMemory& rhs) = delete;
+    constexpr RawMemory(RawMemory&& other) noexcept { 
+        Swap(other);
+    }
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept { 
+        Swap(rhs);
+        return *this;
+    }
+
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
+    }
+
+    constexpr T* operator+(size_t offset) noexcept {
+        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
+        assert(offset <= capacity_);
+        return buffer_ + offset;
+    }
+
+    constexpr const T* operator+(size_t offset) const noexcept {
+        return const_cast<RawMemory&>(*this) + offset;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<RawMemory&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        //std::cout<<index<<"  "<<capacity_<<std::endl;
+        assert(index < capacity_);
+        return buffer_[index];
+    }
+
+    constexpr void Swap(RawMemory& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    constexpr const T* GetAddress() const noexcept {
+        return buffer_;
+    }
+
+    constexpr T* GetAddress() noexcept {
+        return buffer_;
+    }
+
+    constexpr size_t Capacity() const {
+        return capacity_;
+    }
+
+    // Наибольшая ёмкость, представимая типом SizeType
+    static constexpr size_t MaxCapacity() noexcept {
+        return std::numeric_limits<SizeType>::max();
+    }
+
+private:
+    static constexpr size_t CheckCapacity(size_t capacity) {
+        if (capacity > MaxCapacity()) {
+            throw std::length_error("RawMemory capacity exceeds SizeType");
+        }
+        return capacity;
+    }
+
+    // Выделяет сырую память под n элементов и возвращает указатель на неё.
+    // std::allocator, в отличие от operator new, допустим при вычислениях на этапе компиляции
+    static constexpr T* Allocate(size_t n) {
+        return n != 0 ? std::allocator<T>().allocate(n) : nullptr;
+    }
+
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    static constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            std::allocator<T>().deallocate(buf, n);
+        }
+    }
+
+    T* buffer_ = nullptr;
+    SizeType capacity_ = 0;
+};
+
+// Ёмкость хранится перед первым элементом, в заголовке того же блока памяти.
+// Заголовок требует reinterpret_cast, поэтому эта специализация не работает на этапе компиляции
+template <typename T, typename SizeType>
+class RawMemory<T, HeapCapacity<SizeType>> {
 public:
     RawMemory() = default;
 
     explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
+        : buffer_(Allocate(capacity)) {
     }
     
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
     RawMemory(RawMemory&& other) noexcept { 
-        *this=std::move(other);
+        Swap(other);
     }
     RawMemory& operator=(RawMemory&& rhs) noexcept { 
-        buffer_=std::move(rhs.buffer_);
-        capacity_=rhs.capacity_;
+        Swap(rhs);
         return *this;
     }
 
@@ -32,7 +164,7 @@ public:
 
     T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
-        assert(offset <= capacity_);
+        assert(offset <= Capacity());
         return buffer_ + offset;
     }
 
@@ -45,14 +177,12 @@ public:
     }
 
     T& operator[](size_t index) noexcept {
-        //std::cout<<index<<"  "<<capacity_<<std::endl;
-        assert(index < capacity_);
+        assert(index < Capacity());
         return buffer_[index];
     }
 
     void Swap(RawMemory& other) noexcept {
         std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
     }
 
     const T* GetAddress() const noexcept {
@@ -64,95 +194,195 @@ public:
     }
 
     size_t Capacity() const {
-        return capacity_;
+        return buffer_ != nullptr ? *Header(buffer_) : 0;
+    }
+
+    static constexpr size_t MaxCapacity() noexcept {
+        return std::min<size_t>(std::numeric_limits<SizeType>::max(),
+                                (std::numeric_limits<size_t>::max() - HEADER_SIZE) / sizeof(T));
     }
 
 private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
+    // Заголовок занимает целое число "слотов" выравнивания T, чтобы элементы остались выровненными
+    static constexpr size_t ALIGNMENT = std::max(alignof(T), alignof(SizeType));
+    static constexpr size_t HEADER_SIZE = (sizeof(SizeType) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    // Заголовок создан placement new в Allocate, launder даёт доступ именно к этому объекту
+    static SizeType* Header(T* buf) noexcept {
+        return std::launder(reinterpret_cast<SizeType*>(reinterpret_cast<char*>(buf) - HEADER_SIZE));
+    }
+
+    // Выделяет блок из заголовка и n элементов, записывает ёмкость в заголовок.
+    // Элементы T могут содержать поля типа SizeType, поэтому после их записи компилятор
+    // перечитывает заголовок и не может доказать, что ёмкость осталась равной n.
+    // Зная размер блока, GCC тогда предупреждает (-Warray-bounds) о записи за его конец
+    // на невозможном пути "ёмкость больше n". launder скрывает от этого анализа размер блока
     static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+        if (n == 0) {
+            return nullptr;
+        }
+        if (n > MaxCapacity()) {
+            throw std::length_error("RawMemory capacity exceeds SizeType");
+        }
+        char* block = std::launder(
+            static_cast<char*>(operator new(HEADER_SIZE + n * sizeof(T), std::align_val_t{ALIGNMENT})));
+        new (block) SizeType(static_cast<SizeType>(n));
+        return reinterpret_cast<T*>(block + HEADER_SIZE);
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
     static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+        if (buf != nullptr) {
+            operator delete(reinterpret_cast<char*>(buf) - HEADER_SIZE, std::align_val_t{ALIGNMENT});
+        }
     }
 
     T* buffer_ = nullptr;
-    size_t capacity_ = 0;
 };
 
 
 
-template <typename T>
+// Политики переноса элементов при реаллокации.
+// StrongRelocation перемещает элементы, только если перемещение не выбрасывает исключений,
+// а иначе копирует их: реаллокация даёт строгую гарантию безопасности исключений.
+// FastRelocation перемещает всегда: для типов с бросающим перемещением это избавляет
+// от глубоких копий, но при исключении остаётся лишь базовая гарантия
+// (часть элементов вектора может оказаться в состоянии "после перемещения")
+struct StrongRelocation {};
+struct FastRelocation {};
+
+// Отладочный учёт типов, для которых Vector откатился на копирование элементов
+// из-за конструктора перемещения без noexcept. В сборке с NDEBUG не ведётся
+class CopyFallbackReport {
+public:
+    struct Entry {
+        size_t calls = 0;
+        size_t elements = 0;
+    };
+
+    static CopyFallbackReport& Instance() {
+        static CopyFallbackReport report;
+        return report;
+    }
+
+    void Record(const std::type_info& type, size_t elements) {
+        std::lock_guard lock(mutex_);
+        Entry& entry = entries_[type.name()];
+        ++entry.calls;
+        entry.elements += elements;
+    }
+
+    Entry Get(const std::type_info& type) const {
+        std::lock_guard lock(mutex_);
+        const auto it = entries_.find(type.name());
+        return it != entries_.end() ? it->second : Entry{};
+    }
+
+    void Print(std::ostream& out) const {
+        std::lock_guard lock(mutex_);
+        for (const auto& [name, entry] : entries_) {
+            out << "Copy fallback: " << name << " - " << entry.calls << " calls, "
+                << entry.elements << " elements copied\n";
+        }
+    }
+
+    void Reset() {
+        std::lock_guard lock(mutex_);
+        entries_.clear();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+};
+
+// SizeType - беззнаковый тип размера и ёмкости (например, uint32_t, чтобы Vector занимал 16 байт)
+// либо HeapCapacity<S>, чтобы хранить ёмкость в заголовке динамического блока.
+// Relocation - StrongRelocation или FastRelocation
+template <typename T, typename SizeType = size_t, typename Relocation = StrongRelocation>
 class Vector {
 public:
     
-    Vector() = default;
+    constexpr Vector() = default;
     
      using iterator = T*;
     using const_iterator = const T*;
+    using size_type = SizeTypeOf<SizeType>;
     
-    iterator begin() noexcept{
+    constexpr iterator begin() noexcept{
         return data_.GetAddress();
     };
-    iterator end() noexcept{
+    constexpr iterator end() noexcept{
         return data_.GetAddress()+size_;
     };
-    const_iterator begin() const noexcept{
+    constexpr const_iterator begin() const noexcept{
         return data_.GetAddress();
     };
-    const_iterator end() const noexcept{
+    constexpr const_iterator end() const noexcept{
         return data_.GetAddress()+size_;
     };
-    const_iterator cbegin() const noexcept{
+    constexpr const_iterator cbegin() const noexcept{
         return data_.GetAddress();
         
     };
-    const_iterator cend() const noexcept{
+    constexpr const_iterator cend() const noexcept{
         return data_.GetAddress()+size_;
        
     };
     
 
-    explicit Vector(size_t size)
+    constexpr explicit Vector(size_t size)
         : data_(size)
         , size_(size)  //
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        UninitializedValueConstructN(data_.GetAddress(), size);
     }
 
    
-    Vector(const Vector& other)
+    constexpr Vector(const Vector& other)
         : data_(other.size_)        
         , size_(other.size_)  
     {        
-         std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());            
+        VECTOR_PROFILE_SCOPE("CopyConstruct");
+         UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());            
     }  
     
-    Vector(Vector&& other) noexcept{     
+    // Копия other с ёмкостью не меньше capacity: элементы копируются тем же путём,
+    // что и в копирующем конструкторе (memcpy для тривиально копируемых T)
+    constexpr Vector(const Vector& other, size_t capacity)
+        : data_(std::max<size_t>(other.size_, capacity))
+        , size_(other.size_)
+    {
+        VECTOR_PROFILE_SCOPE("CopyConstruct");
+        UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+    }
+
+    constexpr Vector(Vector&& other) noexcept{     
         Swap(other);
     }    
     
-    Vector& operator=(const Vector& rhs) {
+    constexpr Vector& operator=(const Vector& rhs) {
+        VECTOR_PROFILE_SCOPE("CopyAssign");
         if (this != &rhs) {
             if (rhs.size_ > data_.Capacity()) {
                 /* Применить copy-and-swap */
                 Vector rhs_copy(rhs);
                 Swap(rhs_copy);                 
             } 
+            else if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+                /* Ёмкости хватает, а элементы - просто байты: одно копирование без реаллокации */
+                CopyBytes(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+                size_=rhs.size_;
+            }
             else {
                    /* Скопировать элементы из rhs, создав при необходимости новые
                    или удалив существующие */
-                size_t min_size =std::min(size_,rhs.size_);
-                for(size_t i=0; i<min_size; i++){                      
-                    data_[i]=rhs.data_[i];                        
-                }
+                size_t min_size =std::min<size_t>(size_,rhs.size_);
+                std::copy_n(rhs.data_.GetAddress(), min_size, data_.GetAddress());
                 if(rhs.size_<size_){                   
                    std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_); 
                 }                
                 else {
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + size_, rhs.size_ - size_, data_.GetAddress());
+                    UninitializedCopyN(rhs.data_.GetAddress() + size_, rhs.size_ - size_, data_ + size_);
                 }
                 size_=rhs.size_;
             }
@@ -160,87 +390,110 @@ public:
         return *this;
     }
     
-    Vector& operator=(Vector&& rhs) noexcept{       
+    constexpr Vector& operator=(Vector&& rhs) noexcept{       
         Swap(rhs);
         return *this;
     };
     
-    void Swap(Vector& rhs) noexcept{
+    constexpr void Swap(Vector& rhs) noexcept{
         data_.Swap(rhs.data_);
         std::swap(size_,rhs.size_);
          
     }
     
-    void Reserve(size_t new_capacity) {
+    constexpr void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        CopyOrMove (data_.GetAddress(),new_data.GetAddress(),size_);
+        VECTOR_PROFILE_SCOPE("Reserve");
+        Reallocate(new_capacity);
+    }
+
+    // Уничтожает элементы, сохраняя ёмкость
+    constexpr void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);       
-    }    
+        size_ = 0;
+    }
+
+    // Переносит элементы в буфер ёмкостью ровно Size(); пустой вектор освобождает память.
+    // Гарантия безопасности исключений та же, что у Reserve
+    constexpr void ShrinkToFit() {
+        if (data_.Capacity() != size_) {
+            Reallocate(size_);
+        }
+    }
+
+    // Вызывает ShrinkToFit, если ёмкость больше размера в max_slack_ratio раз (max_slack_ratio >= 1).
+    // Возвращает, была ли освобождена память
+    constexpr bool TrimIfSlack(double max_slack_ratio) {
+        assert(max_slack_ratio >= 1.0);
+        if (data_.Capacity() == size_ || data_.Capacity() <= size_ * max_slack_ratio) {
+            return false;
+        }
+        ShrinkToFit();
+        return true;
+    }
     
-    void Resize(size_t new_size){
+    constexpr void Resize(size_t new_size){
         if(new_size < size_){
             std::destroy_n(data_.GetAddress()+new_size, size_- new_size);
             size_ = new_size;
         }
         else{
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+            UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
             size_ = new_size;
         }
     }
     
-    void PushBack(const T& value){        
+    constexpr void PushBack(const T& value){        
         EmplaceBack(value); 
     }
     
-    void PushBack(T&& value) {        
+    constexpr void PushBack(T&& value) {        
         EmplaceBack(std::move(value));        
     }
     
-    void PopBack(){
+    constexpr void PopBack(){
         std::destroy_n(data_.GetAddress()+(size_-1), 1);        
         size_--;
     } 
     
-    size_t Size() const noexcept {
+    constexpr size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    constexpr size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
     
-    ~Vector() {
+    constexpr ~Vector() {
         std::destroy_n(data_.GetAddress(), size_);        
     }
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args){
+    constexpr T& EmplaceBack(Args&&... args){
        if (size_ == Capacity()) {
             return *InputYesRelocation(data_ + size_,std::forward<Args>(args)...);
         } 
         else{            
-            new (data_ + size_) T(std::forward<Args>(args)...);
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
             size_+=1;
             return data_[size_-1];
         }       
     }
     
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args){        
+    constexpr iterator Emplace(const_iterator pos, Args&&... args){        
         if (size_ < Capacity()){              
             return InputNoRelocation(pos,std::forward<Args>(args)...);
         }
@@ -250,21 +503,166 @@ public:
         }
     }
     
-    iterator Insert(const_iterator pos, const T& value){
+    constexpr iterator Insert(const_iterator pos, const T& value){
         return Emplace(pos, value );
     }
     
-    iterator Insert(const_iterator pos, T&& value){
+    constexpr iterator Insert(const_iterator pos, T&& value){
         return Emplace(pos,std::move(value) );
     }
     
-    iterator Erase(const_iterator pos){
+    constexpr iterator Erase(const_iterator pos){
+        VECTOR_PROFILE_SCOPE("Erase");
         auto pos_non_const = const_cast<T*>(pos);
         std::move( pos_non_const+1, end(), pos_non_const );
         std::destroy_n(end()-1,1);
         --size_;
         if (size_==0) return end();
-        else return pos_non_const;        
+        else return pos_non_const;
+    }
+
+    // Добавляет в конец count элементов, созданных из generator(i), где i - номер
+    // добавляемого элемента (или из generator(), если он не принимает номер).
+    // Память выделяется один раз до цикла, и сам цикл не проверяет ёмкость.
+    // Если generator или конструктор T выбросит исключение, уже добавленные в этом
+    // вызове элементы уничтожаются и вектор остаётся прежним (меняется только ёмкость)
+    template <typename Generator>
+    constexpr void AppendN(size_t count, Generator generator){
+        ReserveForAppend(count);
+        T* to = data_ + size_;
+        size_t constructed = 0;
+        try {
+            for (; constructed < count; ++constructed) {
+                if constexpr (std::is_invocable_v<Generator&, size_t>) {
+                    std::construct_at(to + constructed, generator(constructed));
+                } else {
+                    std::construct_at(to + constructed, generator());
+                }
+            }
+        }
+        catch (...) {
+            std::destroy_n(to, constructed);
+            throw;
+        }
+        size_ += count;
+    }
+
+    // Вставка в конец без проверки ёмкости для горячих циклов.
+    // Создаётся методом UncheckedInserter(count) и может добавить не больше count элементов
+    // (проверяется assert). Элементы создаются прямо в буфере,
+    // а размер вектора фиксируется в деструкторе. Если конструктор T выбросит исключение,
+    // элемент не добавляется, а созданные до него останутся в векторе после разрушения вставщика.
+    // Пока вставщик жив, вектор нельзя изменять и читать его Size()
+    class UncheckedBackInserter {
+    public:
+        UncheckedBackInserter(const UncheckedBackInserter&) = delete;
+        UncheckedBackInserter& operator=(const UncheckedBackInserter&) = delete;
+
+        constexpr ~UncheckedBackInserter() {
+            vector_.size_ = static_cast<size_type>(next_ - vector_.data_.GetAddress());
+        }
+
+        template <typename... Args>
+        constexpr T& Emplace(Args&&... args){
+            assert(next_ != end_);
+            std::construct_at(next_, std::forward<Args>(args)...);
+            return *next_++;
+        }
+
+        constexpr void PushBack(const T& value){
+            Emplace(value);
+        }
+
+        constexpr void PushBack(T&& value){
+            Emplace(std::move(value));
+        }
+
+        // Сколько ещё элементов можно добавить
+        constexpr size_t Remaining() const noexcept {
+            return end_ - next_;
+        }
+
+    private:
+        friend class Vector;
+
+        constexpr UncheckedBackInserter(Vector& vector, size_t count) noexcept
+            : vector_(vector)
+            , next_(vector.end())
+            , end_(next_ + count) {
+        }
+
+        Vector& vector_;
+        T* next_;
+        T* end_;
+    };
+
+    // Готовит место под count элементов (ёмкость растёт как в AppendN) и возвращает вставщик,
+    // добавляющий не больше count элементов
+    constexpr UncheckedBackInserter UncheckedInserter(size_t count) {
+        ReserveForAppend(count);
+        return UncheckedBackInserter(*this, count);
+    }
+
+    // Переносит в конец вектора элементы всех sources, выделяя память ровно один раз.
+    // Каждый источник переносится в свой участок буфера в отдельном потоке
+    // (не больше num_threads потоков, 0 - по числу ядер). Источники после успеха пустеют,
+    // сохраняя ёмкость. Элементы переносятся как при реаллокации: если их перемещение
+    // может выбросить исключение, они копируются, и тогда исключение оставляет вектор
+    // и источники без изменений (меняется только ёмкость).
+    // Если же бросающее перемещение всё равно используется (FastRelocation или T без
+    // копирующего конструктора), гарантия лишь базовая: исключение оставляет вектор прежним,
+    // но источники, перенесённые целиком или частично, остаются с элементами
+    // в состоянии "после перемещения", и их данные теряются
+    void ConcatFrom(std::span<Vector> sources, size_t num_threads = 0){
+        Vector<size_t> offsets(sources.size());
+        size_t total = size_;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            assert(&sources[i] != this);
+            offsets[i] = total;
+            total += sources[i].size_;
+        }
+        if (total > RawMemory<T, SizeType>::MaxCapacity()) {
+            throw std::length_error("Vector capacity exceeds SizeType");
+        }
+        Reserve(total);
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        // Небольшие объёмы дешевле перенести в текущем потоке, чем запускать потоки
+        if (total - size_ < PARALLEL_CONCAT_THRESHOLD) {
+            num_threads = 1;
+        }
+        
+        // Если перенос не бросает исключений, откатывать нечего, и источник уничтожается
+        // в той же задаче, пока его участок ещё в кэше. Иначе источники нужны до конца
+        // переноса и уничтожаются после него в текущем потоке
+        constexpr bool DESTROY_IN_TASK = RELOCATE_BY_MOVE && std::is_nothrow_move_constructible_v<T>;
+        T* base = data_.GetAddress();
+        Vector<std::exception_ptr> errors = ParallelFor(sources.size(), num_threads, [&](size_t i) {
+            CopyOrMove(sources[i].data_.GetAddress(), base + offsets[i], sources[i].size_);
+            if constexpr (DESTROY_IN_TASK) {
+                std::destroy_n(sources[i].data_.GetAddress(), sources[i].size_);
+            }
+        });
+        auto failed = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+            return error != nullptr;
+        });
+        if (failed != errors.end()) {
+            // Участок упавшего источника уже очищен uninitialized-алгоритмом, остальные чистим здесь
+            for (size_t i = 0; i < sources.size(); ++i) {
+                if (errors[i] == nullptr) {
+                    std::destroy_n(base + offsets[i], sources[i].size_);
+                }
+            }
+            std::rethrow_exception(*failed);
+        }
+        size_ = total;
+        for (Vector& source : sources) {
+            if constexpr (!DESTROY_IN_TASK && !std::is_trivially_destructible_v<T>) {
+                std::destroy_n(source.data_.GetAddress(), source.size_);
+            }
+            source.size_ = 0;
+        }
     }
     
     
@@ -272,36 +670,165 @@ public:
     
 private:
     
-    template<typename FirstIter, typename SecondIter>
-    void CopyOrMove (FirstIter from, SecondIter to, size_t number){
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+    // Аналоги std::uninitialized_*_n, допустимые при вычислениях на этапе компиляции.
+    // Исключение на этапе компиляции прерывает вычисление, поэтому откат там не нужен.
+    // Во время выполнения используются стандартные алгоритмы
+    static constexpr void UninitializedValueConstructN(T* to, size_t number){
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < number; ++i) {
+                std::construct_at(to + i);
+            }
+        }
+        else {
+            std::uninitialized_value_construct_n(to, number);
+        }
+    }
+    
+    template<typename InputIter>
+    static constexpr void UninitializedCopyN(InputIter from, size_t number, T* to){
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < number; ++i, ++from) {
+                std::construct_at(to + i, *from);
+            }
+        }
+        else if constexpr (std::is_trivially_copyable_v<T> && std::is_convertible_v<InputIter, const T*>) {
+            CopyBytes(from, number, to);
+        }
+        else {
+            std::uninitialized_copy_n(from, number, to);
+        }
+    }
+
+    // Копирует тривиально копируемые элементы одним memcpy (только во время выполнения).
+    // Проверка to избыточна (при number != 0 буфер всегда есть), но без неё GCC
+    // выдаёт ложное предупреждение -Wnonnull для встроенного пути copy-and-swap
+    static void CopyBytes(const T* from, size_t number, T* to) noexcept {
+        if (number != 0 && to != nullptr) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), number * sizeof(T));
+        }
+    }
+    
+    template<typename InputIter>
+    static constexpr void UninitializedMoveN(InputIter from, size_t number, T* to){
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < number; ++i, ++from) {
+                std::construct_at(to + i, std::move(*from));
+            }
+        }
+        else {
             std::uninitialized_move_n(from, number, to);
+        }
+    }
+    
+    // Переносит элементы в новый буфер ёмкостью new_capacity >= size_
+    constexpr void Reallocate(size_t new_capacity){
+        RawMemory<T, SizeType> new_data(new_capacity);
+        CopyOrMove (data_.GetAddress(),new_data.GetAddress(),size_);
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    }
+
+    // Ёмкость при росте: удвоение, но не больше представимого SizeType.
+    // Если расти некуда, выбрасывает std::length_error до каких-либо изменений
+    constexpr size_t NextCapacity() const {
+        const size_t max_capacity = RawMemory<T, SizeType>::MaxCapacity();
+        if (size_ >= max_capacity) {
+            throw std::length_error("Vector capacity exceeds SizeType");
+        }
+        if (size_ == 0) {
+            return 1;
+        }
+        return size_ > max_capacity / 2 ? max_capacity : size_t{size_} * 2;
+    }
+
+    // Готовит место под count новых элементов. Ёмкость растёт не меньше чем вдвое,
+    // чтобы серия небольших AppendN оставалась амортизированно линейной
+    constexpr void ReserveForAppend(size_t count){
+        const size_t max_capacity = RawMemory<T, SizeType>::MaxCapacity();
+        if (count > max_capacity - size_) {
+            throw std::length_error("Vector capacity exceeds SizeType");
+        }
+        const size_t required = size_ + count;
+        if (required > data_.Capacity()) {
+            const size_t doubled = data_.Capacity() > max_capacity / 2 ? max_capacity : data_.Capacity() * 2;
+            Reserve(std::max(required, doubled));
+        }
+    }
+
+    static constexpr bool RELOCATE_BY_MOVE = std::is_nothrow_move_constructible_v<T>
+                                             || !std::is_copy_constructible_v<T>
+                                             || std::is_same_v<Relocation, FastRelocation>;
+    
+    template<typename FirstIter, typename SecondIter>
+    constexpr void CopyOrMove (FirstIter from, SecondIter to, size_t number){
+        if constexpr (RELOCATE_BY_MOVE) {
+            UninitializedMoveN(from, number, to);
         } else {
-            std::uninitialized_copy_n(from, number, to);
+#ifndef NDEBUG
+            if (!std::is_constant_evaluated()) {
+                CopyFallbackReport::Instance().Record(typeid(T), number);
+            }
+#endif
+            UninitializedCopyN(from, number, to);
         }
     } 
     
+    // Как CopyOrMove, но при исключении дополнительно уничтожает number_to_clean
+    // уже созданных элементов, начиная с clean_from, и пробрасывает исключение дальше
     template<typename FirstIter, typename SecondIter,typename CleanIter>
-    void CleanCopyOrMove(FirstIter from, SecondIter to, size_t number_to_move_copy, CleanIter clean_from, size_t number_to_clean){
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(from, number_to_move_copy, to);
-            } 
-            else {
-                try{
-                    std::uninitialized_copy_n(from, number_to_move_copy, to);
-                }
-                catch(...){
-                    std::destroy_n(clean_from, number_to_clean);
-                }
-            }            
+    constexpr void CleanCopyOrMove(FirstIter from, SecondIter to, size_t number_to_move_copy, CleanIter clean_from, size_t number_to_clean){
+        try{
+            CopyOrMove(from, to, number_to_move_copy);
+        }
+        catch(...){
+            std::destroy_n(clean_from, number_to_clean);
+            throw;
+        }
     }
         
        
+    static constexpr size_t PARALLEL_CONCAT_THRESHOLD = 1 << 14;
+    
+    // Выполняет task(i) для всех i из [0, count) в num_threads потоках (включая текущий).
+    // Возвращает исключения, выброшенные для каждого i
+    template <typename Task>
+    static Vector<std::exception_ptr> ParallelFor(size_t count, size_t num_threads, Task task){
+        Vector<std::exception_ptr> errors(count);
+        std::atomic<size_t> next_index = 0;
+        auto worker = [&]() noexcept {
+            for (size_t i = next_index++; i < count; i = next_index++) {
+                try {
+                    task(i);
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+        // Текущий поток тоже выполняет задачи, поэтому дополнительных потоков на один меньше
+        const size_t num_workers = std::min(num_threads, count);
+        Vector<std::thread> threads;
+        threads.Reserve(num_workers > 0 ? num_workers - 1 : 0);
+        try {
+            while (threads.Size() < threads.Capacity()) {
+                threads.EmplaceBack(worker);
+            }
+        }
+        catch (...) {
+            // Не удалось запустить поток: оставшуюся работу сделают уже запущенные и текущий
+        }
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return errors;
+    }
+    
     template <typename... Args>
-    iterator InputNoRelocation(const const_iterator pos, Args&&... args){
+    constexpr iterator InputNoRelocation(const const_iterator pos, Args&&... args){
         auto pos_non_const = const_cast<T*>(pos);
             if (pos==end()){               
-                new (pos_non_const) T(std::forward<Args>(args)...);               
+                std::construct_at(pos_non_const, std::forward<Args>(args)...);               
             }
             else {                
                 T temp_val(std::forward<Args>(args)...);
@@ -314,24 +841,37 @@ private:
     }    
     
     template <typename... Args>
-    iterator InputYesRelocation(const const_iterator pos, Args&&... args){
+    constexpr iterator InputYesRelocation(const const_iterator pos, Args&&... args){
+        VECTOR_PROFILE_SCOPE("InputYesRelocation");
     auto pos_non_const = const_cast<T*>(pos);            
-            Vector<T> new_data(0);
-            if (size_==0) new_data.Reserve(1);
-            else new_data.Reserve(size_*2);
-            new_data.size_ = size_;
-            int dist_before = pos_non_const - begin();
-            int dist_after = end()- pos_non_const;
+            Vector new_data;
+            new_data.Reserve(NextCapacity());
+            size_t dist_before = pos_non_const - begin();
+            size_t dist_after = end()- pos_non_const;
             auto iter = new_data.data_.GetAddress() + dist_before;
-            new (iter) T(std::forward<Args>(args)...);           
+            std::construct_at(iter, std::forward<Args>(args)...);           
             CleanCopyOrMove(begin(), new_data.data_.GetAddress(),dist_before, iter, 1); 
             CleanCopyOrMove(pos_non_const,  iter+1, dist_after, new_data.data_.GetAddress(), dist_before+1);
+            // Размер выставляется только после успешного переноса, чтобы при исключении
+            // деструктор new_data не уничтожал несозданные элементы
+            new_data.size_ = size_;
             Swap(new_data);
             ++size_;            
             return (begin()+dist_before);     
     }
        
-    RawMemory<T> data_;    
-    size_t size_ = 0;   
+    // Хвостовое выравнивание RawMemory может быть занято size_:
+    // для SizeType = uint32_t указатель, ёмкость и размер укладываются в 16 байт
+    [[no_unique_address]] RawMemory<T, SizeType> data_;    
+    size_type size_ = 0;   
     
-};
\ No newline at end of file
+};
+
+// Собирает элементы частей, заполненных, например, разными потоками, в один вектор
+// с единственным выделением памяти. См. Vector::ConcatFrom
+template <typename T, typename... Options>
+Vector<T, Options...> ParallelCollect(std::span<Vector<T, Options...>> parts, size_t num_threads = 0) {
+    Vector<T, Options...> result;
+    result.ConcatFrom(parts, num_threads);
+    return result;
+}
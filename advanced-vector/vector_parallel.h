@@ -0,0 +1,184 @@
+#pragma once
+#include "thread_pool.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+// Параллельные алгоритмы над буфером Vector на ThreadPool.
+// Буфер делится на участки, внутренние границы которых приходятся на начало кэш-линии,
+// поэтому потоки, пишущие в соседние участки, не делят одну линию (false sharing).
+// Участков в несколько раз больше, чем потоков, чтобы перехват работы выравнивал нагрузку,
+// но не меньше MIN_CHUNK_BYTES каждый: небольшие векторы обрабатываются одним участком
+// прямо в вызывающем потоке.
+//
+// Функции, передаваемые в алгоритмы, вызываются из нескольких потоков одновременно.
+
+namespace parallel_detail {
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+inline constexpr size_t CHUNKS_PER_THREAD = 4;
+inline constexpr size_t MIN_CHUNK_BYTES = 16 * 1024;
+
+// Границы участков для size элементов, начинающихся с data: участок i - [bounds[i], bounds[i + 1]).
+// Участки непусты (кроме единственного участка пустого диапазона).
+// Если элементы не могут начинать кэш-линию (адрес data не кратен gcd(64, sizeof(T))),
+// границы не выравниваются
+template <typename T>
+Vector<size_t> ChunkBounds(const T* data, size_t size, size_t num_threads) {
+    const size_t max_chunks = std::max<size_t>(1, size * sizeof(T) / MIN_CHUNK_BYTES);
+    const size_t num_chunks = std::min(std::max<size_t>(1, num_threads) * CHUNKS_PER_THREAD, max_chunks);
+
+    // Элементы, начинающие кэш-линию, идут с шагом step, первый из них - first_aligned
+    const size_t misalignment = reinterpret_cast<uintptr_t>(data) % CACHE_LINE_SIZE;
+    size_t step = CACHE_LINE_SIZE / std::gcd(CACHE_LINE_SIZE, sizeof(T));
+    size_t first_aligned = 0;
+    while (first_aligned < step && (misalignment + first_aligned * sizeof(T)) % CACHE_LINE_SIZE != 0) {
+        ++first_aligned;
+    }
+    if (first_aligned == step) {
+        step = 1;
+        first_aligned = 0;
+    }
+
+    Vector<size_t> bounds;
+    bounds.Reserve(num_chunks + 1);
+    bounds.PushBack(0);
+    for (size_t i = 1; i < num_chunks; ++i) {
+        const size_t raw = size / num_chunks * i + size % num_chunks * i / num_chunks;
+        if (raw < first_aligned) {
+            continue;
+        }
+        const size_t bound = first_aligned + (raw - first_aligned) / step * step;
+        if (bound > bounds[bounds.Size() - 1]) {
+            bounds.PushBack(bound);
+        }
+    }
+    if (size > bounds[bounds.Size() - 1] || bounds.Size() == 1) {
+        bounds.PushBack(size);
+    }
+    return bounds;
+}
+
+// Вызывает func(first, last) для каждого участка [first, last) в пуле
+template <typename T, typename Func>
+void ForEachChunk(ThreadPool& pool, const T* data, size_t size, Func func) {
+    const Vector<size_t> bounds = ChunkBounds(data, size, pool.NumThreads());
+    pool.Run(bounds.Size() - 1, [&](size_t i) {
+        func(bounds[i], bounds[i + 1]);
+    });
+}
+
+}  // namespace parallel_detail
+
+// Вызывает func(element) для каждого элемента
+template <typename T, typename... Options, typename Func>
+void ParallelForEach(ThreadPool& pool, Vector<T, Options...>& v, Func func) {
+    T* data = v.begin();
+    parallel_detail::ForEachChunk(pool, data, v.Size(), [&](size_t first, size_t last) {
+        std::for_each(data + first, data + last, func);
+    });
+}
+
+// Записывает func(src[i]) в dst[i]. Размер dst должен заранее совпадать с размером src
+template <typename T, typename U, typename... SrcOptions, typename... DstOptions, typename Func>
+void ParallelTransform(ThreadPool& pool, const Vector<T, SrcOptions...>& src, Vector<U, DstOptions...>& dst,
+                       Func func) {
+    if (dst.Size() != src.Size()) {
+        throw std::invalid_argument("ParallelTransform: destination size differs from source size");
+    }
+    const T* from = src.begin();
+    U* to = dst.begin();
+    // Участки выравниваются по приёмнику: в него пишут потоки
+    parallel_detail::ForEachChunk(pool, to, dst.Size(), [&](size_t first, size_t last) {
+        std::transform(from + first, from + last, to + first, func);
+    });
+}
+
+namespace parallel_detail {
+
+// Сворачивает участки параллельно: участок начинается с R(load(первый элемент)),
+// затем value = op(value, load(элемент)); частичные результаты сворачиваются с init по порядку
+template <typename T, typename R, typename Op, typename Load>
+R ReduceChunks(ThreadPool& pool, const T* data, size_t size, R init, Op& op, Load& load) {
+    if (size == 0) {
+        return init;
+    }
+    // Частичные результаты в отдельных кэш-линиях, чтобы потоки не мешали друг другу
+    struct alignas(CACHE_LINE_SIZE) Partial {
+        std::optional<R> value;
+    };
+    const Vector<size_t> bounds = ChunkBounds(data, size, pool.NumThreads());
+    Vector<Partial> partials(bounds.Size() - 1);
+    pool.Run(partials.Size(), [&](size_t i) {
+        R value(load(data[bounds[i]]));
+        for (size_t j = bounds[i] + 1; j < bounds[i + 1]; ++j) {
+            value = op(std::move(value), load(data[j]));
+        }
+        partials[i].value.emplace(std::move(value));
+    });
+    for (Partial& partial : partials) {
+        init = op(std::move(init), std::move(*partial.value));
+    }
+    return init;
+}
+
+}  // namespace parallel_detail
+
+// Свёртка элементов с init в духе std::reduce: op(R, R) -> R должна быть ассоциативной,
+// а элементы T - приводиться к R. Каждый участок сворачивается начиная со своего первого
+// элемента, а результаты участков сворачиваются между собой, поэтому op применяется и к
+// элементам, и к частичным результатам. Коммутативность не требуется: порядок сохраняется.
+// Для разнородных операций (например, подсчёта элементов по условию) - ParallelTransformReduce
+template <typename T, typename... Options, typename R, typename Op = std::plus<>>
+R ParallelReduce(ThreadPool& pool, const Vector<T, Options...>& v, R init, Op op = Op()) {
+    static_assert(std::is_convertible_v<const T&, R>, "ParallelReduce: elements must be convertible to R");
+    static_assert(std::is_invocable_r_v<R, Op&, R, R>, "ParallelReduce: op must combine two R values into R");
+    auto load = [](const T& value) -> const T& {
+        return value;
+    };
+    return parallel_detail::ReduceChunks(pool, v.begin(), v.Size(), std::move(init), op, load);
+}
+
+// Свёртка reduce(... reduce(init, transform(v[0])) ..., transform(v[n - 1])) с произвольной
+// расстановкой скобок: transform(const T&) -> R, reduce(R, R) -> R - ассоциативная операция
+template <typename T, typename... Options, typename R, typename Reduce, typename Transform>
+R ParallelTransformReduce(ThreadPool& pool, const Vector<T, Options...>& v, R init, Reduce reduce,
+                          Transform transform) {
+    static_assert(std::is_invocable_r_v<R, Transform&, const T&>,
+                  "ParallelTransformReduce: transform must map an element to R");
+    static_assert(std::is_invocable_r_v<R, Reduce&, R, R>,
+                  "ParallelTransformReduce: reduce must combine two R values into R");
+    return parallel_detail::ReduceChunks(pool, v.begin(), v.Size(), std::move(init), reduce, transform);
+}
+
+// Сортирует участки параллельно, затем сливает их попарно (std::inplace_merge) за log2(участков)
+// раундов. Число слияний в раунде вдвое меньше, чем в предыдущем, поэтому последнее слияние
+// выполняется одним потоком. Пул из одного потока просто вызывает std::sort. Сортировка неустойчивая
+template <typename T, typename... Options, typename Compare = std::less<>>
+void ParallelSort(ThreadPool& pool, Vector<T, Options...>& v, Compare comp = Compare()) {
+    T* data = v.begin();
+    if (pool.NumThreads() == 1) {
+        std::sort(data, data + v.Size(), comp);
+        return;
+    }
+    const Vector<size_t> bounds = parallel_detail::ChunkBounds(data, v.Size(), pool.NumThreads());
+    const size_t num_chunks = bounds.Size() - 1;
+    pool.Run(num_chunks, [&](size_t i) {
+        std::sort(data + bounds[i], data + bounds[i + 1], comp);
+    });
+    for (size_t width = 1; width < num_chunks; width *= 2) {
+        const size_t num_merges = (num_chunks - width + 2 * width - 1) / (2 * width);
+        pool.Run(num_merges, [&](size_t i) {
+            const size_t first = i * 2 * width;
+            const size_t middle = first + width;
+            const size_t last = std::min(middle + width, num_chunks);
+            std::inplace_merge(data + bounds[first], data + bounds[middle], data + bounds[last], comp);
+        });
+    }
+}
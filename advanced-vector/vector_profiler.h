@@ -0,0 +1,229 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+// Профилирование операций Vector по аппаратным счётчикам производительности.
+// Счётчики открываются через perf_event_open для текущего потока; если ядро, права
+// (kernel.perf_event_paranoid) или виртуальная машина не дают открыть счётчик,
+// он просто возвращает нули. Вне Linux все счётчики недоступны.
+//
+// Vector вызывает профилировщик, только если перед подключением vector.h
+// определён макрос VECTOR_PROFILING. Замеры включают вложенные операции:
+// например, InputYesRelocation содержит и вызванный внутри Reserve.
+
+// Показания счётчиков. Недоступный счётчик всегда равен нулю
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t page_faults = 0;
+
+    constexpr PerfSample& operator+=(const PerfSample& other) noexcept {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cache_misses += other.cache_misses;
+        page_faults += other.page_faults;
+        return *this;
+    }
+
+    constexpr PerfSample operator-(const PerfSample& other) const noexcept {
+        return {cycles - other.cycles, instructions - other.instructions, cache_misses - other.cache_misses,
+                page_faults - other.page_faults};
+    }
+};
+
+// Набор счётчиков текущего потока
+class PerfCounters {
+public:
+    static PerfCounters& ThisThread() {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (const int fd : {cycles_fd_, instructions_fd_, cache_misses_fd_, page_faults_fd_}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    // Открыт ли хотя бы один счётчик
+    bool IsAvailable() const noexcept {
+        return cycles_fd_ >= 0 || instructions_fd_ >= 0 || cache_misses_fd_ >= 0 || page_faults_fd_ >= 0;
+    }
+
+    bool HasHardwareCounters() const noexcept {
+        return cycles_fd_ >= 0;
+    }
+
+    PerfSample Read() const noexcept {
+        return {ReadCounter(cycles_fd_), ReadCounter(instructions_fd_), ReadCounter(cache_misses_fd_),
+                ReadCounter(page_faults_fd_)};
+    }
+
+private:
+    PerfCounters()
+#ifdef __linux__
+        : cycles_fd_(Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        , instructions_fd_(Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS))
+        , cache_misses_fd_(Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES))
+        , page_faults_fd_(Open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS))
+#endif
+    {
+    }
+
+#ifdef __linux__
+    // Счётчики открываются по отдельности, а не группой: так программные page faults
+    // остаются доступны и там, где аппаратных счётчиков нет
+    static int Open(uint32_t type, uint64_t config) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        // Только пользовательский режим: так счётчики доступны при perf_event_paranoid = 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    static uint64_t ReadCounter(int fd) noexcept {
+#ifdef __linux__
+        uint64_t value = 0;
+        if (fd >= 0 && read(fd, &value, sizeof(value)) == sizeof(value)) {
+            return value;
+        }
+#else
+        (void)fd;
+#endif
+        return 0;
+    }
+
+    int cycles_fd_ = -1;
+    int instructions_fd_ = -1;
+    int cache_misses_fd_ = -1;
+    int page_faults_fd_ = -1;
+};
+
+// Сводка замеров по операциям и типам элементов для всего процесса
+class VectorProfile {
+public:
+    struct Stats {
+        size_t calls = 0;
+        PerfSample total;
+    };
+
+    static VectorProfile& Instance() {
+        static VectorProfile profile;
+        return profile;
+    }
+
+    void Record(const char* operation, const std::type_info& type, const PerfSample& sample) noexcept {
+        try {
+            std::lock_guard lock(mutex_);
+            Stats& stats = stats_[{operation, type.name()}];
+            ++stats.calls;
+            stats.total += sample;
+        } catch (...) {
+            // Профилирование не должно ломать профилируемую программу
+        }
+    }
+
+    Stats Get(const std::string& operation, const std::type_info& type) const {
+        std::lock_guard lock(mutex_);
+        const auto it = stats_.find({operation, type.name()});
+        return it != stats_.end() ? it->second : Stats{};
+    }
+
+    void Print(std::ostream& out) const {
+        std::lock_guard lock(mutex_);
+        if (!PerfCounters::ThisThread().HasHardwareCounters()) {
+            out << "Vector profile: hardware counters are unavailable, only page faults are reported\n";
+        }
+        for (const auto& [key, stats] : stats_) {
+            out << key.first << '<' << Demangle(key.second) << ">: " << stats.calls << " calls, "
+                << stats.total.cycles << " cycles, " << stats.total.instructions << " instructions, "
+                << stats.total.cache_misses << " cache misses, " << stats.total.page_faults << " page faults\n";
+        }
+    }
+
+    void Reset() {
+        std::lock_guard lock(mutex_);
+        stats_.clear();
+    }
+
+private:
+    static std::string Demangle(const std::string& name) {
+#ifdef __GNUC__
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> demangled(
+            abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status), &std::free);
+        if (status == 0 && demangled != nullptr) {
+            return demangled.get();
+        }
+#endif
+        return name;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::pair<std::string, std::string>, Stats> stats_;
+};
+
+// Замеряет счётчики между созданием и разрушением и записывает разницу в VectorProfile.
+// Конструктор и деструктор constexpr, чтобы объект можно было создавать в constexpr-функциях Vector;
+// при вычислении на этапе компиляции ничего не замеряется
+class ScopedPerfCounter {
+public:
+    constexpr ScopedPerfCounter(const char* operation, const std::type_info& type) noexcept
+        : operation_(operation)
+        , type_(&type) {
+        if (!std::is_constant_evaluated()) {
+            start_ = PerfCounters::ThisThread().Read();
+        }
+    }
+
+    ScopedPerfCounter(const ScopedPerfCounter&) = delete;
+    ScopedPerfCounter& operator=(const ScopedPerfCounter&) = delete;
+
+    constexpr ~ScopedPerfCounter() {
+        if (!std::is_constant_evaluated()) {
+            VectorProfile::Instance().Record(operation_, *type_, PerfCounters::ThisThread().Read() - start_);
+        }
+    }
+
+private:
+    const char* operation_;
+    const std::type_info* type_;
+    PerfSample start_;
+};
+
+// Точка замера внутри шаблонов Vector: T - тип элемента
+#ifdef VECTOR_PROFILING
+#define VECTOR_PROFILE_SCOPE(operation) ScopedPerfCounter vector_profile_scope(operation, typeid(T))
+#else
+#define VECTOR_PROFILE_SCOPE(operation)
+#endif
@@ -0,0 +1,420 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Векторизованные операции над буфером Vector<T> для T = float, double, int32_t, int64_t.
+// Ядра пишутся один раз на векторных расширениях GCC/Clang и инстанцируются
+// под SSE4.2, AVX2 и AVX-512; нужный вариант выбирается во время выполнения.
+// Если процессор (или платформа) не поддерживает ни один из них, используется скалярный вариант.
+//
+// Порядок суммирования в SIMD-ветке отличается от последовательного,
+// поэтому Sum для float/double может расходиться со скалярным результатом в последних битах.
+// Transform и Axpy округляют произведение отдельно от суммы на любом наборе инструкций:
+// объединение в FMA (target("avx512f") включает эти инструкции) дало бы результат,
+// зависящий от процессора.
+// MinMax не обрабатывает NaN.
+
+#if defined(__GNUC__) && defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_SIMD_X86 1
+#endif
+
+// GCC по умолчанию объединяет умножение и сложение в FMA даже между выражениями.
+// Clang делает это только внутри одного выражения, поэтому ядра записывают их раздельно
+#if defined(__GNUC__) && !defined(__clang__)
+#define VECTOR_SIMD_NO_FP_CONTRACT optimize("fp-contract=off")
+#else
+#define VECTOR_SIMD_NO_FP_CONTRACT
+#endif
+
+enum class SimdLevel {
+    SCALAR,
+    SSE4_2,
+    AVX2,
+    AVX512,
+};
+
+namespace simd_detail {
+
+template <typename T>
+inline constexpr bool IS_SIMD_TYPE = std::is_same_v<T, float> || std::is_same_v<T, double>
+                                     || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>;
+
+inline SimdLevel DetectSimdLevel() noexcept {
+#ifdef VECTOR_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::SSE4_2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+inline SimdLevel& ActiveLevel() noexcept {
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+// Количество элементов до первого адреса, выровненного на BYTES (не больше n)
+template <size_t BYTES, typename T>
+[[gnu::always_inline]] inline size_t HeadCount(const T* data, size_t n) noexcept {
+    const size_t misalignment = reinterpret_cast<uintptr_t>(data) % BYTES;
+    const size_t head = misalignment == 0 ? 0 : (BYTES - misalignment) / sizeof(T);
+    return head < n ? head : n;
+}
+
+// Каждая операция описывается структурой с двумя реализациями:
+// RunScalar - эталонный последовательный цикл, Run<BYTES> - SIMD-ядро с шириной регистра BYTES.
+// Run<BYTES> не содержит target-атрибутов и встраивается в обёртки RunSse/RunAvx2/RunAvx512,
+// которые и определяют набор инструкций.
+
+struct FillOp {
+    template <typename T>
+    static void RunScalar(T* data, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = value;
+        }
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline void Run(T* data, size_t n, T value) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        RunScalar(data, i, value);
+        const V v = value - V{};
+        for (; i + LANES <= n; i += LANES) {
+            *reinterpret_cast<V*>(data + i) = v;
+        }
+        RunScalar(data + i, n - i, value);
+    }
+};
+
+struct IotaOp {
+    template <typename T>
+    static void RunScalar(T* data, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = value++;
+        }
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline void Run(T* data, size_t n, T value) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        RunScalar(data, i, value);
+        V current;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            current[lane] = value + static_cast<T>(i + lane);
+        }
+        const V step = static_cast<T>(LANES) - V{};
+        for (; i + LANES <= n; i += LANES) {
+            *reinterpret_cast<V*>(data + i) = current;
+            current += step;
+        }
+        RunScalar(data + i, n - i, static_cast<T>(value + static_cast<T>(i)));
+    }
+};
+
+struct SumOp {
+    template <typename T>
+    static T RunScalar(const T* data, size_t n) {
+        T sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline T Run(const T* data, size_t n) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        T sum = RunScalar(data, i);
+        V acc = {};
+        for (; i + LANES <= n; i += LANES) {
+            acc += *reinterpret_cast<const V*>(data + i);
+        }
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            sum += acc[lane];
+        }
+        return sum + RunScalar(data + i, n - i);
+    }
+};
+
+struct MinMaxOp {
+    template <typename T>
+    static std::pair<T, T> RunScalar(const T* data, size_t n, std::pair<T, T> result) {
+        for (size_t i = 0; i < n; ++i) {
+            result.first = data[i] < result.first ? data[i] : result.first;
+            result.second = result.second < data[i] ? data[i] : result.second;
+        }
+        return result;
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline std::pair<T, T> Run(const T* data, size_t n,
+                                                             std::pair<T, T> result) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        result = RunScalar(data, i, result);
+        V mn = result.first - V{};
+        V mx = result.second - V{};
+        for (; i + LANES <= n; i += LANES) {
+            const V x = *reinterpret_cast<const V*>(data + i);
+            mn = x < mn ? x : mn;
+            mx = mx < x ? x : mx;
+        }
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            result.first = mn[lane] < result.first ? mn[lane] : result.first;
+            result.second = result.second < mx[lane] ? mx[lane] : result.second;
+        }
+        return RunScalar(data + i, n - i, result);
+    }
+};
+
+struct FindOp {
+    template <typename T>
+    static size_t RunScalar(const T* data, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline size_t Run(const T* data, size_t n, T value) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        // Тип слова зависит от T, иначе GCC не применяет зависимый vector_size к typedef
+        using Word = std::conditional_t<sizeof(T) != 0, uint64_t, T>;
+        typedef Word W __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        if (const size_t pos = RunScalar(data, i, value); pos != i) {
+            return pos;
+        }
+        const V v = value - V{};
+        for (; i + LANES <= n; i += LANES) {
+            const W mask = reinterpret_cast<W>(*reinterpret_cast<const V*>(data + i) == v);
+            uint64_t any = 0;
+            for (size_t word = 0; word < BYTES / sizeof(uint64_t); ++word) {
+                any |= mask[word];
+            }
+            if (any != 0) {
+                return i + RunScalar(data + i, LANES, value);
+            }
+        }
+        return i + RunScalar(data + i, n - i, value);
+    }
+};
+
+struct CountOp {
+    template <typename T>
+    static size_t RunScalar(const T* data, size_t n, T value) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            count += data[i] == value;
+        }
+        return count;
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline size_t Run(const T* data, size_t n, T value) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        // Счётчики в дорожках имеют ширину T, поэтому периодически сбрасываем их в size_t
+        constexpr size_t CHUNK = LANES << 30;
+        size_t i = HeadCount<BYTES>(data, n);
+        size_t count = RunScalar(data, i, value);
+        const V v = value - V{};
+        while (i + LANES <= n) {
+            const size_t chunk_end = n - i > CHUNK ? i + CHUNK : n;
+            decltype(v == v) acc = {};
+            for (; i + LANES <= chunk_end; i += LANES) {
+                // Результат сравнения: -1 в совпавших дорожках, 0 в остальных
+                acc -= *reinterpret_cast<const V*>(data + i) == v;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                count += static_cast<size_t>(acc[lane]);
+            }
+        }
+        return count + RunScalar(data + i, n - i, value);
+    }
+};
+
+struct TransformOp {
+    template <typename T>
+    __attribute__((VECTOR_SIMD_NO_FP_CONTRACT)) static void RunScalar(T* data, size_t n, T mul, T add) {
+        for (size_t i = 0; i < n; ++i) {
+            const T product = data[i] * mul;
+            data[i] = product + add;
+        }
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline void Run(T* data, size_t n, T mul, T add) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        size_t i = HeadCount<BYTES>(data, n);
+        RunScalar(data, i, mul, add);
+        const V m = mul - V{};
+        const V a = add - V{};
+        for (; i + LANES <= n; i += LANES) {
+            V& x = *reinterpret_cast<V*>(data + i);
+            const V product = x * m;
+            x = product + a;
+        }
+        RunScalar(data + i, n - i, mul, add);
+    }
+};
+
+struct AxpyOp {
+    template <typename T>
+    __attribute__((VECTOR_SIMD_NO_FP_CONTRACT)) static void RunScalar(T* y, const T* x, size_t n, T a) {
+        for (size_t i = 0; i < n; ++i) {
+            const T product = a * x[i];
+            y[i] += product;
+        }
+    }
+
+    template <size_t BYTES, typename T>
+    [[gnu::always_inline]] static inline void Run(T* y, const T* x, size_t n, T a) {
+        typedef T V __attribute__((vector_size(BYTES)));
+        constexpr size_t LANES = BYTES / sizeof(T);
+        // Выравниваем по y, x читаем невыровненными загрузками
+        size_t i = HeadCount<BYTES>(y, n);
+        RunScalar(y, x, i, a);
+        const V av = a - V{};
+        for (; i + LANES <= n; i += LANES) {
+            V xv;
+            std::memcpy(&xv, x + i, sizeof(xv));
+            const V product = av * xv;
+            *reinterpret_cast<V*>(y + i) += product;
+        }
+        RunScalar(y + i, x + i, n - i, a);
+    }
+};
+
+#ifdef VECTOR_SIMD_X86
+template <typename Op, typename... Args>
+__attribute__((target("sse4.2"), VECTOR_SIMD_NO_FP_CONTRACT)) auto RunSse(Args... args) {
+    return Op::template Run<16>(args...);
+}
+
+template <typename Op, typename... Args>
+__attribute__((target("avx2"), VECTOR_SIMD_NO_FP_CONTRACT)) auto RunAvx2(Args... args) {
+    return Op::template Run<32>(args...);
+}
+
+template <typename Op, typename... Args>
+__attribute__((target("avx512f"), VECTOR_SIMD_NO_FP_CONTRACT)) auto RunAvx512(Args... args) {
+    return Op::template Run<64>(args...);
+}
+#endif
+
+template <typename Op, typename... Args>
+auto Dispatch(Args... args) {
+#ifdef VECTOR_SIMD_X86
+    switch (ActiveLevel()) {
+        case SimdLevel::AVX512:
+            return RunAvx512<Op>(args...);
+        case SimdLevel::AVX2:
+            return RunAvx2<Op>(args...);
+        case SimdLevel::SSE4_2:
+            return RunSse<Op>(args...);
+        case SimdLevel::SCALAR:
+            break;
+    }
+#endif
+    return Op::RunScalar(args...);
+}
+
+}  // namespace simd_detail
+
+// Набор инструкций, который поддерживает текущий процессор
+inline SimdLevel DetectedSimdLevel() noexcept {
+    static const SimdLevel level = simd_detail::DetectSimdLevel();
+    return level;
+}
+
+// Набор инструкций, который сейчас используют операции ниже
+inline SimdLevel ActiveSimdLevel() noexcept {
+    return simd_detail::ActiveLevel();
+}
+
+// Принудительно понижает используемый набор инструкций (например, для сравнения со скалярной версией).
+// Уровень выше поддерживаемого процессором ограничивается DetectedSimdLevel()
+inline void ForceSimdLevel(SimdLevel level) noexcept {
+    simd_detail::ActiveLevel() = level < DetectedSimdLevel() ? level : DetectedSimdLevel();
+}
+
+template <typename T, typename... Options>
+void Fill(Vector<T, Options...>& v, T value) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    simd_detail::Dispatch<simd_detail::FillOp>(v.begin(), v.Size(), value);
+}
+
+// Заполняет v значениями value, value + 1, value + 2, ...
+template <typename T, typename... Options>
+void Iota(Vector<T, Options...>& v, T value) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    simd_detail::Dispatch<simd_detail::IotaOp>(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename... Options>
+T Sum(const Vector<T, Options...>& v) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    return simd_detail::Dispatch<simd_detail::SumOp>(v.begin(), v.Size());
+}
+
+// Возвращает пару {минимум, максимум}. Вектор не должен быть пустым
+template <typename T, typename... Options>
+std::pair<T, T> MinMax(const Vector<T, Options...>& v) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    assert(v.Size() != 0);
+    return simd_detail::Dispatch<simd_detail::MinMaxOp>(v.begin(), v.Size(),
+                                                        std::pair<T, T>{v[0], v[0]});
+}
+
+// Возвращает итератор на первый элемент, равный value, либо end()
+template <typename T, typename... Options>
+typename Vector<T, Options...>::const_iterator Find(const Vector<T, Options...>& v, T value) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    return v.begin() + simd_detail::Dispatch<simd_detail::FindOp>(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename... Options>
+size_t Count(const Vector<T, Options...>& v, T value) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    return simd_detail::Dispatch<simd_detail::CountOp>(v.begin(), v.Size(), value);
+}
+
+// v[i] = v[i] * mul + add
+template <typename T, typename... Options>
+void Transform(Vector<T, Options...>& v, T mul, T add) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    simd_detail::Dispatch<simd_detail::TransformOp>(v.begin(), v.Size(), mul, add);
+}
+
+// y[i] += a * x[i]. Размеры векторов должны совпадать
+template <typename T, typename... Options>
+void Axpy(Vector<T, Options...>& y, T a, const Vector<T, Options...>& x) {
+    static_assert(simd_detail::IS_SIMD_TYPE<T>);
+    assert(y.Size() == x.Size());
+    simd_detail::Dispatch<simd_detail::AxpyOp>(y.begin(), x.begin(), y.Size(), a);
+}